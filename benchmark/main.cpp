@@ -5,6 +5,7 @@
 #include <benchmark/benchmark.h>
 
 #include "../include/hash_table.hpp"
+#include <array>
 #include <random>
 #include <unordered_set>
 #include <unordered_map>
@@ -85,6 +86,34 @@ static void Access(benchmark::State& state) {
 #endif
 }
 
+template <typename HashTable>
+static void AccessBatched(benchmark::State& state) {
+	static constexpr std::size_t batch_size {64};
+	HashTable ht(iter_count);
+	int res {1};
+	for (int i = 0; i != iter_count; ++i){
+		insertion(res, ht);
+	}
+	std::array<int, batch_size> keys;
+	std::array<typename HashTable::const_iterator, batch_size> found;
+	for (auto _ : state) {
+		for (int &key : keys) {
+			key = distrib(gen);
+		}
+		ht.find_many(keys, found);
+		benchmark::DoNotOptimize(found);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * batch_size);
+	state.counters["ns/op"] = benchmark::Counter(
+		state.iterations() * batch_size,
+		benchmark::Counter::kIsRate | benchmark::Counter::kInvert
+	);
+#ifndef __APPLE__
+	state.counters["cycles"] = benchmark::Counter::kDefaults;
+#endif
+}
+
 auto eraseFrom = [](auto &ht){
 	int key {distrib(gen)};
 	auto found = ht.find(key);
@@ -140,6 +169,9 @@ BENCHMARK_TEMPLATE(Access, containers::hash_table::Set<int>)           BENCHMARK
 BENCHMARK_TEMPLATE(Access, std::unordered_map<int,int>)                BENCHMARK_HT_PARAMS("Access std::unordered_map             ")
 BENCHMARK_TEMPLATE(Access, containers::hash_table::Map<int,int>)       BENCHMARK_HT_PARAMS("Access containers::hash_table::Map    ")
 
+BENCHMARK_TEMPLATE(AccessBatched, containers::hash_table::Set<int>)    BENCHMARK_HT_PARAMS("Access batched hash_table::Set        ")
+BENCHMARK_TEMPLATE(AccessBatched, containers::hash_table::Map<int,int>)BENCHMARK_HT_PARAMS("Access batched hash_table::Map        ")
+
 BENCHMARK_TEMPLATE(Erase, std::unordered_set<int>)                     BENCHMARK_HT_PARAMS("Erase std::unordered_set              ")
 BENCHMARK_TEMPLATE(Erase, containers::hash_table::Set<int>)            BENCHMARK_HT_PARAMS("Erase containers::hash_table::Set     ")
 BENCHMARK_TEMPLATE(Erase, std::unordered_map<int,int>)                 BENCHMARK_HT_PARAMS("Erase std::unordered_map              ")
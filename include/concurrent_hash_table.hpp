@@ -0,0 +1,1456 @@
+//
+// Concurrent variants of the hash table
+//
+
+#pragma once
+
+#include "hash_table.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <shared_mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace containers {
+
+	namespace hash_table {
+
+		namespace details {
+
+			namespace const_values {
+
+				constexpr inline std::size_t cacheLineSize {64};
+				constexpr inline std::size_t readerStripes {32};
+				constexpr inline std::size_t retireBatch {1<<10};
+				//below maxLoadFactor, so the index is grown by the maintenance thread before an insert has to
+				constexpr inline double maintenanceWatermark {0.375};
+				constexpr inline std::chrono::milliseconds maintenancePeriod {50};
+
+			}//!namespace details::const_values
+
+			//stripe of the calling thread, for the per-thread counters spread over several cache lines
+			inline std::size_t threadStripe() {
+				thread_local std::size_t const index {std::hash<std::thread::id>{}(std::this_thread::get_id()) % const_values::readerStripes};
+				return index;
+			}
+
+			/**
+			 * Grace periods for lock-free readers. A reader counts itself in one of two counters, the one of the
+			 * current epoch, in a stripe picked by its thread, so readers don't fight for one cache line.
+			 * The writer flips the epoch and waits for the counters of the previous one to drain — after that
+			 * nothing unpublished before the flip can be reached by anyone, and it may be freed.
+			 * */
+			class ReaderEpochs {
+			private:
+				struct alignas(const_values::cacheLineSize) Stripe {
+					std::array<std::atomic<std::size_t>, 2> readers {};
+				};
+
+			public:
+				class [[nodiscard]] Section {
+				public:
+					Section(Section const&) = delete;
+					Section& operator=(Section const&) = delete;
+					~Section() { readers.fetch_sub(1); }
+
+				private:
+					friend ReaderEpochs;
+					explicit Section(std::atomic<std::size_t> &readers_) : readers {readers_} {}
+					std::atomic<std::size_t> &readers;
+				};
+
+				Section read() const {
+					Stripe &stripe {stripes[threadStripe()]};
+					for (;;) {
+						std::uint64_t const current {epoch.load()};
+						std::atomic<std::size_t> &readers {stripe.readers[current & 1]};
+						readers.fetch_add(1);
+						//if the epoch has moved meanwhile, the writer may have looked at this counter already
+						if (epoch.load() == current) {
+							return Section {readers};
+						}
+						readers.fetch_sub(1);
+					}
+				}
+
+				void synchronize() {
+					std::size_t const previous {static_cast<std::size_t>(epoch.fetch_add(1) & 1)};
+					for (Stripe const &stripe : stripes) {
+						while (stripe.readers[previous].load() != 0) {
+							std::this_thread::yield();
+						}
+					}
+				}
+
+			private:
+				mutable std::array<Stripe, const_values::readerStripes> stripes {};
+				std::atomic<std::uint64_t> epoch {0};
+			};
+
+			/**
+			 * One writer thread, any number of readers, that take no lock at all. Index slots are atomic pointers
+			 * to the values, those are allocated one by one and never move. The writer never changes a published
+			 * value — an update publishes a new node in the same slot. Rehash builds a new index aside and publishes
+			 * it with one store. Replaced indexes and erased or replaced nodes are retired, and freed in batches
+			 * after a grace period of ReaderEpochs.
+			 * */
+			template <typename T, typename Hasher, typename KeyEqual, requirements::Type t>
+			class SingleWriterHashTable {
+			private:
+				static constexpr requirements::Type type {t};
+
+				static constexpr auto getKeyType(){
+					if constexpr (requirements::is_map_v<type>) {
+						return std::type_identity<typename T::first_type>{};
+					}
+					else {
+						return std::type_identity<T>{};
+					}
+				}
+
+			public:
+				using key_type = typename decltype(getKeyType())::type;
+				using value_type = T;
+				using hasher = Hasher;
+				using key_equal = KeyEqual;
+
+				SingleWriterHashTable() : SingleWriterHashTable(0) {}
+
+				explicit SingleWriterHashTable(std::size_t initialCapacity,
+											   std::pmr::memory_resource* nodeResource = std::pmr::get_default_resource())
+					: allocator {nodeResource}
+					, current {std::make_unique<Index>(CapacityPolicy{initialCapacity, sizeof(T const*)}.capacity())}
+					, published {current.get()}
+				{}
+
+				SingleWriterHashTable(SingleWriterHashTable const&) = delete;
+				SingleWriterHashTable& operator=(SingleWriterHashTable const&) = delete;
+
+				//there should be no readers left by now
+				~SingleWriterHashTable() {
+					for (std::size_t i {0}; i != current->capacity(); ++i) {
+						T const* value {current->slots[i].load()};
+						if (isValue(value)) {
+							destroy(value);
+						}
+					}
+					freeRetired();
+				}
+
+				//readers side, from any thread
+
+				template <typename Fn>
+				bool visit(key_type const& key, Fn&& fn) const {
+					auto const section {epochs.read()};
+					T const* found {lookup(*published.load(), key)};
+					if (found == nullptr) {
+						return false;
+					}
+					std::invoke(std::forward<Fn>(fn), *found);
+					return true;
+				}
+
+				bool contains(key_type const& key) const {
+					auto const section {epochs.read()};
+					return lookup(*published.load(), key) != nullptr;
+				}
+
+				//writer side, from one thread at a time
+
+				bool insert(value_type value) {
+					std::size_t const hash {hasher_(keyOf(value))};
+					auto [slot, found] {probeForInsert(keyOf(value), hash)};
+					if (found) {
+						return false;
+					}
+					slot->store(allocator.template new_object<T>(std::move(value)));
+					++sz;
+					return true;
+				}
+
+				bool erase(key_type const& key) {
+					std::atomic<T const*>* slot {writerLookup(key, hasher_(key))};
+					if (slot == nullptr) {
+						return false;
+					}
+					T const* value {slot->load()};
+					slot->store(tombstone());
+					--sz;
+					++deleted_count;
+					retire(value);
+					tryShrink();
+					return true;
+				}
+
+				//frees what has been retired so far, waiting for the readers that may still see it
+				void reclaim() {
+					if (!retiredNodes.empty() || !retiredIndexes.empty()) {
+						epochs.synchronize();
+						freeRetired();
+					}
+				}
+
+				std::size_t size() const noexcept { return sz; }
+				bool empty() const noexcept { return sz == 0; }
+				std::size_t capacity() const noexcept { return current->capacity(); }
+
+			protected:
+				struct Index {
+					explicit Index(std::size_t capacity_)
+						: mask {capacity_ - 1}
+						, slots {std::make_unique<std::atomic<T const*>[]>(capacity_)}
+					{}
+					std::size_t capacity() const noexcept { return mask + 1; }
+
+					std::size_t mask;
+					std::unique_ptr<std::atomic<T const*>[]> slots;
+				};
+
+				//erased slot, still a part of probe sequences, never dereferenced
+				static T const* tombstone() noexcept { return reinterpret_cast<T const*>(alignof(T)); }
+				static bool isValue(T const* value) noexcept { return value != nullptr && value != tombstone(); }
+
+				static key_type const& keyOf(value_type const& value) {
+					if constexpr (requirements::is_map_v<type>) {
+						return value.first;
+					}
+					else {
+						return value;
+					}
+				}
+
+				//same probe sequence as HashTable has
+				T const* lookup(Index const& index, key_type const& key) const {
+					std::size_t h {hasher_(key) & index.mask};
+					std::size_t const step {h | 1};
+					for (std::size_t i {0}; i != index.capacity(); ++i) {
+						T const* value {index.slots[h].load()};
+						if (value == nullptr) {
+							return nullptr;
+						}
+						if (value != tombstone() && equal(keyOf(*value), key)) {
+							return value;
+						}
+						h = (h + step) & index.mask;
+					}
+					return nullptr;
+				}
+
+				std::atomic<T const*>* writerLookup(key_type const& key, std::size_t hash) {
+					std::size_t h {hash & current->mask};
+					std::size_t const step {h | 1};
+					for (std::size_t i {0}; i != current->capacity(); ++i) {
+						T const* value {current->slots[h].load(std::memory_order_relaxed)};
+						if (value == nullptr) {
+							return nullptr;
+						}
+						if (value != tombstone() && equal(keyOf(*value), key)) {
+							return &current->slots[h];
+						}
+						h = (h + step) & current->mask;
+					}
+					return nullptr;
+				}
+
+				//slot holding the key and true, or a free slot for it and false; grows the index beforehand if needed
+				std::pair<std::atomic<T const*>*, bool> probeForInsert(key_type const& key, std::size_t hash) {
+					if (1.0 * (sz + deleted_count + 1) / current->capacity() > const_values::maxLoadFactor) {
+						rebuild(current->capacity() << 1);
+					}
+					std::size_t h {hash & current->mask};
+					std::size_t const step {h | 1};
+					for (std::size_t i {0}; i != current->capacity(); ++i) {
+						T const* value {current->slots[h].load(std::memory_order_relaxed)};
+						if (value == nullptr) {
+							return {&current->slots[h], false};
+						}
+						if (value != tombstone() && equal(keyOf(*value), key)) {
+							return {&current->slots[h], true};
+						}
+						h = (h + step) & current->mask;
+					}
+					throw std::runtime_error("Unable to emplace, consider reducing const_values::maxLoadFactor");
+				}
+
+				void tryShrink() {
+					std::size_t targetCapacity {current->capacity()};
+					while (targetCapacity > const_values::initial_capacity && 1.0 * sz / (targetCapacity >> 1) <= const_values::maxLoadFactor) {
+						targetCapacity >>= 1;
+					}
+					if (targetCapacity < current->capacity()) {
+						rebuild(targetCapacity);
+					}
+				}
+
+				//the new index is filled while nobody sees it and then published with one store
+				void rebuild(std::size_t newCapacity) {
+					auto fresh {std::make_unique<Index>(newCapacity)};
+					for (std::size_t i {0}; i != current->capacity(); ++i) {
+						T const* value {current->slots[i].load(std::memory_order_relaxed)};
+						if (!isValue(value)) {
+							continue;
+						}
+						std::size_t h {hasher_(keyOf(*value)) & fresh->mask};
+						std::size_t const step {h | 1};
+						while (fresh->slots[h].load(std::memory_order_relaxed) != nullptr) {
+							h = (h + step) & fresh->mask;
+						}
+						fresh->slots[h].store(value, std::memory_order_relaxed);
+					}
+					published.store(fresh.get());
+					retiredIndexes.push_back(std::move(current));
+					current = std::move(fresh);
+					deleted_count = 0;
+					reclaim();
+				}
+
+				void retire(T const* value) {
+					retiredNodes.push_back(value);
+					if (retiredNodes.size() >= const_values::retireBatch) {
+						reclaim();
+					}
+				}
+
+				void freeRetired() {
+					for (T const* value : retiredNodes) {
+						destroy(value);
+					}
+					retiredNodes.clear();
+					retiredIndexes.clear();
+				}
+
+				void destroy(T const* value) {
+					allocator.delete_object(const_cast<T*>(value));
+				}
+
+				std::pmr::polymorphic_allocator<T> allocator;
+				std::unique_ptr<Index> current;
+				std::atomic<Index const*> published;
+				std::vector<T const*> retiredNodes;
+				std::vector<std::unique_ptr<Index>> retiredIndexes;
+				ReaderEpochs epochs;
+				std::size_t sz {0};
+				std::size_t deleted_count {0};
+				Hasher hasher_;
+				KeyEqual equal;
+			};
+
+			/**
+			 * Flat combining: a thread publishes its operation in a record and whoever gets the combiner flag
+			 * executes all the published operations at once. So the table is touched by one thread at a time
+			 * with no lock handoff per operation, the index is grown once for all the inserts of a batch,
+			 * and lookups of a batch go through find_many().
+			 * Callbacks of visit() and upsert() are run by the combiner thread, not necessarily by the caller.
+			 * */
+			template <typename Table>
+			class FlatCombiningHashTable {
+			public:
+				using key_type = typename Table::key_type;
+				using value_type = typename Table::value_type;
+				using hasher = typename Table::hasher;
+				using key_equal = typename Table::key_equal;
+
+				//arguments of the table, a FlatCombiningHashTable itself is not one of them, it is not copyable
+				template <typename... Args>
+				requires std::constructible_from<Table, Args...> &&
+				(!(sizeof...(Args) == 1 && (std::derived_from<std::remove_cvref_t<Args>, FlatCombiningHashTable> && ...)))
+				explicit FlatCombiningHashTable(Args&&... args) : table (std::forward<Args>(args)...) {
+					//so the combiner doesn't allocate on its own behalf, there is no record to blame for that
+					batch.reserve(records.size());
+					keys.reserve(records.size());
+					lookups.reserve(records.size());
+				}
+
+				FlatCombiningHashTable(FlatCombiningHashTable const&) = delete;
+				FlatCombiningHashTable& operator=(FlatCombiningHashTable const&) = delete;
+
+				bool insert(value_type value) {
+					return run([&value](Record &record) {
+						record.operation = Operation::Insert;
+						record.value.emplace(std::move(value));
+					});
+				}
+
+				bool erase(key_type const& key) {
+					return run([&key](Record &record) {
+						record.operation = Operation::Erase;
+						record.key = &key;
+					});
+				}
+
+				bool contains(key_type const& key) {
+					return run([&key](Record &record) {
+						record.operation = Operation::Contains;
+						record.key = &key;
+					});
+				}
+
+				template <typename Fn>
+				bool visit(key_type const& key, Fn&& fn) {
+					return run([&key, &fn](Record &record) {
+						record.operation = Operation::Visit;
+						record.key = &key;
+						record.context = std::addressof(fn);
+						record.visitor = [](void* context, value_type const& value) {
+							std::invoke(*static_cast<std::remove_reference_t<Fn>*>(context), value);
+						};
+					});
+				}
+
+				//under the combiner flag, waits for the current batch
+				std::size_t size() {
+					lock();
+					CombinerGuard const guard {*this};
+					return table.size();
+				}
+
+				bool empty() { return size() == 0; }
+
+			protected:
+				enum class Operation : std::uint8_t { Insert, Erase, Contains, Visit, Upsert };
+
+				using mutable_type = std::remove_cvref_t<decltype(*std::declval<Table&>().begin())>;
+
+				struct alignas(const_values::cacheLineSize) Record {
+					std::atomic<bool> owned {false};
+					std::atomic<bool> pending {false};
+					Operation operation {Operation::Insert};
+					key_type const* key {nullptr};
+					std::optional<value_type> value;
+					void* context {nullptr};
+					void (*visitor)(void*, value_type const&) {nullptr};
+					void (*updater)(void*, mutable_type&) {nullptr};
+					bool result {false};
+					std::exception_ptr error;
+				};
+
+				template <typename Setup>
+				bool run(Setup &&setup) {
+					Record &record {acquireRecord()};
+					setup(record);
+					record.pending.store(true, std::memory_order_release);
+					for (std::size_t spins {0}; record.pending.load(std::memory_order_acquire); ++spins) {
+						if (tryLock()) {
+							CombinerGuard const guard {*this};
+							combine();
+						}
+						else if (spins % 64 == 63) {
+							std::this_thread::yield();
+						}
+					}
+					bool const result {record.result};
+					std::exception_ptr const error {std::exchange(record.error, nullptr)};
+					record.owned.store(false, std::memory_order_release);
+					if (error) {
+						std::rethrow_exception(error);
+					}
+					return result;
+				}
+
+				//with more threads than records the rest wait for one to be given back, yielding after each round
+				Record& acquireRecord() {
+					for (std::size_t idx {threadStripe()}, tries {1};; idx = (idx + 1) % records.size(), ++tries) {
+						if (!records[idx].owned.load(std::memory_order_relaxed) && !records[idx].owned.exchange(true, std::memory_order_acquire)) {
+							return records[idx];
+						}
+						if (tries % records.size() == 0) {
+							std::this_thread::yield();
+						}
+					}
+				}
+
+				//the combiner flag is given back however the batch ends
+				struct CombinerGuard {
+					FlatCombiningHashTable &owner;
+					~CombinerGuard() { owner.unlock(); }
+				};
+
+				bool tryLock() {
+					return !combining.load(std::memory_order_relaxed) && !combining.exchange(true, std::memory_order_acquire);
+				}
+
+				void lock() {
+					while (!tryLock()) {
+						std::this_thread::yield();
+					}
+				}
+
+				void unlock() { combining.store(false, std::memory_order_release); }
+
+				void combine() {
+					batch.clear();
+					std::size_t inserts {0};
+					for (Record &record : records) {
+						if (record.pending.load(std::memory_order_acquire)) {
+							batch.push_back(&record);
+							inserts += record.operation == Operation::Insert || record.operation == Operation::Upsert;
+						}
+					}
+					if (inserts > 1) {
+						try {
+							table.reserve(table.size() + inserts);
+						}
+						catch (...) {
+							//not fatal, every insert still grows the index on its own
+						}
+					}
+					bool looked {false};
+					try {
+						looked = lookupBatch();
+					}
+					catch (...) {
+						//hasher or key_equal threw for some of the keys, each lookup is repeated on its own to find out whose
+					}
+					for (Record *record : batch) {
+						if (record->operation != Operation::Contains || !looked) {
+							try {
+								execute(*record);
+							}
+							catch (...) {
+								record->error = std::current_exception();
+							}
+						}
+						record->value.reset();
+						record->pending.store(false, std::memory_order_release);
+					}
+				}
+
+				//keys of the contains() are copied, so that's only for the keys cheap to copy; true if it is done
+				bool lookupBatch() {
+					if constexpr (batchedLookups) {
+						keys.clear();
+						lookups.clear();
+						for (Record *record : batch) {
+							if (record->operation == Operation::Contains) {
+								keys.push_back(*record->key);
+								lookups.push_back(record);
+							}
+						}
+						for (std::size_t first {0}; first < keys.size(); first += found.size()) {
+							std::size_t const count {std::min(found.size(), keys.size() - first)};
+							table.find_many(std::span<key_type const>{keys}.subspan(first, count), std::span{found}.first(count));
+							for (std::size_t i {0}; i != count; ++i) {
+								lookups[first + i]->result = found[i] != table.cend();
+							}
+						}
+					}
+					return batchedLookups;
+				}
+
+				void execute(Record &record) {
+					switch (record.operation) {
+						case Operation::Insert:
+							record.result = table.insert(std::move(*record.value)).second;
+							break;
+						case Operation::Erase: {
+							std::size_t const before {table.size()};
+							table.erase(*record.key);
+							record.result = table.size() != before;
+							break;
+						}
+						case Operation::Contains:
+							record.result = table.contains(*record.key);
+							break;
+						case Operation::Visit: {
+							auto const found_ {std::as_const(table).find(*record.key)};
+							record.result = found_ != table.cend();
+							if (record.result) {
+								record.visitor(record.context, *found_);
+							}
+							break;
+						}
+						case Operation::Upsert:
+							if constexpr (requires { table.try_emplace(*record.key); }) {
+								auto [iter, inserted] {table.try_emplace(*record.key)};
+								record.updater(record.context, *iter);
+								record.result = inserted;
+							}
+							break;
+					}
+				}
+
+				static constexpr bool batchedLookups {std::is_trivially_copyable_v<key_type>};
+
+				std::array<Record, const_values::readerStripes> records {};
+				std::atomic<bool> combining {false};
+				//used by the combiner only
+				std::vector<Record*> batch;
+				std::vector<std::remove_cv_t<key_type>> keys;
+				std::vector<Record*> lookups;
+				std::array<typename Table::const_iterator, const_values::findManyGroup * 4> found {};
+				Table table;
+			};
+
+			//erase_if() of the tables is a hidden friend, so it is reachable by ADL only
+			template <typename Table, typename Pred>
+			std::size_t eraseIfFrom(Table &table, Pred &pred) {
+				return erase_if(table, pred);
+			}
+
+			/**
+			 * Key space is split by the high bits of a mixed hash into independent tables,
+			 * each one with its own lock and its own node pool, so threads working with different shards
+			 * don't meet at all. The hash is computed once and passed down to the shard's table.
+			 * Elements are never relocated, but they may only be touched under the lock — through visit(), upsert() etc.
+			 * */
+			template <typename Table>
+			class ShardedHashTable {
+			public:
+				using key_type = typename Table::key_type;
+				using value_type = typename Table::value_type;
+				using hasher = typename Table::hasher;
+				using key_equal = typename Table::key_equal;
+
+				static constexpr requirements::Type type {std::same_as<value_type, key_type> ? requirements::Type::Set : requirements::Type::Map};
+
+				explicit ShardedHashTable(std::size_t shardCount = defaultShardCount())
+					: shardBits {std::countr_zero(std::bit_ceil(std::max<std::size_t>(shardCount, 1)))}
+					, shards {std::make_unique<Shard[]>(std::size_t{1} << shardBits)}
+					, hasher_ {shards[0].table.hash_function()}
+				{}
+
+				ShardedHashTable(ShardedHashTable const&) = delete;
+				ShardedHashTable& operator=(ShardedHashTable const&) = delete;
+
+				~ShardedHashTable() { stop_maintenance(); }
+
+				std::size_t shard_count() const noexcept { return std::size_t{1} << shardBits; }
+
+				/**
+				 * Background maintenance: the shards don't shrink and don't purge tombstones on erase() anymore,
+				 * a thread does that, and grows a shard ahead, once its load is over the watermark.
+				 * The thread wakes up every period, or earlier, when an insert finds its shard over the watermark.
+				 * It checks a shard under the shared lock and takes the exclusive one only if there is work.
+				 * Not to be called concurrently with stop_maintenance().
+				 * */
+				void start_maintenance(double watermark = const_values::maintenanceWatermark, std::chrono::milliseconds period = const_values::maintenancePeriod) {
+					if (maintenance.thread.joinable()) {
+						throw std::logic_error("ShardedHashTable, maintenance is started already");
+					}
+					for (Shard &shard : shardRange()) {
+						std::unique_lock const lock {shard.mutex};
+						//checks the watermark as well
+						shard.table.needsMaintenance(watermark);
+						shard.table.setDeferredMaintenance(true);
+					}
+					maintenance.stopping = false;
+					maintenance.period = period;
+					maintenance.watermark.store(watermark, std::memory_order_release);
+					maintenance.thread = std::thread {[this] { maintain(); }};
+				}
+
+				//back to maintenance by the writers themselves
+				void stop_maintenance() {
+					if (!maintenance.thread.joinable()) {
+						return;
+					}
+					{
+						std::lock_guard const lock {maintenance.mutex};
+						maintenance.stopping = true;
+					}
+					maintenance.wakeup.notify_one();
+					maintenance.thread.join();
+					maintenance.watermark.store(0.0, std::memory_order_release);
+					for (Shard &shard : shardRange()) {
+						std::unique_lock const lock {shard.mutex};
+						shard.table.setDeferredMaintenance(false);
+					}
+				}
+
+				bool insert(value_type value) {
+					std::size_t const hash {hashFunction(keyOf(value))};
+					Shard &shard {shardFor(hash)};
+					std::unique_lock lock {shard.mutex};
+					bool const inserted {shard.table.insert_with_hash(std::move(value), hash).second};
+					if (double const watermark {maintenance.watermark.load(std::memory_order_relaxed)}; watermark != 0.0 && shard.table.needsMaintenance(watermark)) {
+						lock.unlock();
+						nudge();
+					}
+					return inserted;
+				}
+
+				bool contains(key_type const& key) const {
+					std::size_t const hash {hashFunction(key)};
+					Shard const &shard {shardFor(hash)};
+					std::shared_lock const lock {shard.mutex};
+					return shard.table.contains(key, hash);
+				}
+
+				/**
+				 * fn(value_type const&) is called under the shared lock of the shard, if the key is there.
+				 * */
+				template <typename Fn>
+				bool visit(key_type const& key, Fn&& fn) const {
+					std::size_t const hash {hashFunction(key)};
+					Shard const &shard {shardFor(hash)};
+					std::shared_lock const lock {shard.mutex};
+					auto const found {std::as_const(shard.table).find(key, hash)};
+					if (found == shard.table.cend()) {
+						return false;
+					}
+					std::invoke(std::forward<Fn>(fn), *found);
+					return true;
+				}
+
+				bool erase(key_type const& key) {
+					std::size_t const hash {hashFunction(key)};
+					Shard &shard {shardFor(hash)};
+					std::unique_lock const lock {shard.mutex};
+					std::size_t const before {shard.table.size()};
+					shard.table.erase(key, hash);
+					return shard.table.size() != before;
+				}
+
+				//shard by shard, each one under its exclusive lock
+				template <typename Pred>
+				std::size_t erase_if(Pred pred) {
+					std::size_t erased {0};
+					for (Shard &shard : shardRange()) {
+						std::unique_lock const lock {shard.mutex};
+						erased += eraseIfFrom(shard.table, pred);
+					}
+					return erased;
+				}
+
+				//shard by shard, each one under its shared lock, so it is not a snapshot of the whole table
+				template <typename Fn>
+				void for_each(Fn fn) const {
+					for (Shard const &shard : shardRange()) {
+						std::shared_lock const lock {shard.mutex};
+						for (value_type const& value : shard.table) {
+							fn(value);
+						}
+					}
+				}
+
+				std::size_t size() const {
+					std::size_t total {0};
+					for (Shard const &shard : shardRange()) {
+						std::shared_lock const lock {shard.mutex};
+						total += shard.table.size();
+					}
+					return total;
+				}
+
+				bool empty() const { return size() == 0; }
+
+				void clear() {
+					for (Shard &shard : shardRange()) {
+						std::unique_lock const lock {shard.mutex};
+						shard.table.clear();
+					}
+				}
+
+			protected:
+				struct alignas(const_values::cacheLineSize) Shard {
+					mutable std::shared_mutex mutex;
+					//the pool is not synchronized, the shard's lock takes care of it
+					pmr::PoolResource resource;
+					Table table {0, &resource};
+				};
+
+				struct Maintenance {
+					//0 when there is no maintenance thread
+					std::atomic<double> watermark {0.0};
+					//set by the first insert that finds its shard over the watermark, until the thread comes
+					std::atomic<bool> nudged {false};
+					std::chrono::milliseconds period {const_values::maintenancePeriod};
+					std::mutex mutex;
+					std::condition_variable wakeup;
+					bool stopping {false};
+					std::thread thread;
+				};
+
+				void nudge() {
+					if (!maintenance.nudged.exchange(true, std::memory_order_relaxed)) {
+						std::lock_guard const lock {maintenance.mutex};
+						maintenance.wakeup.notify_one();
+					}
+				}
+
+				void maintain() {
+					double const watermark {maintenance.watermark.load(std::memory_order_acquire)};
+					std::unique_lock lock {maintenance.mutex};
+					while (!maintenance.stopping) {
+						lock.unlock();
+						maintenance.nudged.store(false, std::memory_order_relaxed);
+						for (Shard &shard : shardRange()) {
+							{
+								std::shared_lock const check {shard.mutex};
+								if (!shard.table.needsMaintenance(watermark)) {
+									continue;
+								}
+							}
+							std::unique_lock const update {shard.mutex};
+							shard.table.maintain(watermark);
+						}
+						lock.lock();
+						maintenance.wakeup.wait_for(lock, maintenance.period, [this] {
+							return maintenance.stopping || maintenance.nudged.load(std::memory_order_relaxed);
+						});
+					}
+				}
+
+				static std::size_t defaultShardCount() {
+					return std::bit_ceil(std::max(2u * std::thread::hardware_concurrency(), 1u));
+				}
+
+				//the shards hash with copies of this one, it is not copied per call
+				std::size_t hashFunction(key_type const& key) const {
+					return hasher_(key);
+				}
+
+				//a set of pairs is a set still, its key is the whole pair
+				static key_type const& keyOf(value_type const& value) {
+					if constexpr (requirements::is_map_v<type>) {
+						return value.first;
+					}
+					else {
+						return value;
+					}
+				}
+
+				//high bits of the hash spread by a multiplication, the table itself uses the low ones
+				Shard& shardFor(std::size_t hash) const {
+					if (shardBits == 0) {
+						return shards[0];
+					}
+					std::uint64_t const mixed {static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull};
+					return shards[static_cast<std::size_t>(mixed >> (64 - shardBits))];
+				}
+
+				std::span<Shard> shardRange() const { return {shards.get(), shard_count()}; }
+
+				int shardBits;
+				std::unique_ptr<Shard[]> shards;
+				hasher hasher_;
+				Maintenance maintenance;
+			};
+
+			/**
+			 * Bounded ring for exactly one producer and one consumer, head and tail are on their own cache lines.
+			 * */
+			template <typename T>
+			class SpscRing {
+			public:
+				explicit SpscRing(std::size_t capacity)
+					: mask {std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1}
+					, slots {std::make_unique<T[]>(mask + 1)}
+				{}
+
+				bool push(T &value) {
+					std::size_t const tail_ {tail.load(std::memory_order_relaxed)};
+					if (tail_ - head.load(std::memory_order_acquire) > mask) {
+						return false;
+					}
+					slots[tail_ & mask] = std::move(value);
+					tail.store(tail_ + 1, std::memory_order_release);
+					return true;
+				}
+
+				bool pop(T &value) {
+					std::size_t const head_ {head.load(std::memory_order_relaxed)};
+					if (head_ == tail.load(std::memory_order_acquire)) {
+						return false;
+					}
+					value = std::move(slots[head_ & mask]);
+					head.store(head_ + 1, std::memory_order_release);
+					return true;
+				}
+
+			private:
+				std::size_t const mask;
+				std::unique_ptr<T[]> slots;
+				alignas(const_values::cacheLineSize) std::atomic<std::size_t> head {0};
+				alignas(const_values::cacheLineSize) std::atomic<std::size_t> tail {0};
+			};
+
+		}//!namespace details
+
+		template <typename T, typename Hasher = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+		struct ConcurrentSet final : public details::ShardedHashTable<Set<T, Hasher, KeyEqual>>
+		{
+		private:
+			using base_type = details::ShardedHashTable<Set<T, Hasher, KeyEqual>>;
+		public:
+			using key_type = typename base_type::key_type;
+			using value_type = typename base_type::value_type;
+			using hasher = typename base_type::hasher;
+			using key_equal = typename base_type::key_equal;
+
+			using base_type::base_type;
+		};
+
+		template <typename Key, typename Value, typename Hasher = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+		struct ConcurrentMap final : public details::ShardedHashTable<Map<Key, Value, Hasher, KeyEqual>>
+		{
+		private:
+			using base_type = details::ShardedHashTable<Map<Key, Value, Hasher, KeyEqual>>;
+		public:
+			using key_type = typename base_type::key_type;
+			using mapped_type = Value;
+			using value_type = typename base_type::value_type;
+			using hasher = typename base_type::hasher;
+			using key_equal = typename base_type::key_equal;
+
+			using base_type::base_type;
+
+			bool insert(Key const& key, Value value) {
+				return base_type::insert(value_type{key, std::move(value)});
+			}
+
+			using base_type::insert;
+
+			/**
+			 * Atomic read-modify-write: fn(Value&) is called under the exclusive lock of the shard,
+			 * on the existing value or on a default constructed one, that is inserted first.
+			 * Returns true if the key was inserted.
+			 * */
+			template <typename Fn>
+			requires std::default_initializable<Value> && std::invocable<Fn&, Value&>
+			bool upsert(Key const& key, Fn&& fn) {
+				std::size_t const hash {this->hashFunction(key)};
+				auto &shard {this->shardFor(hash)};
+				std::unique_lock const lock {shard.mutex};
+				auto [iter, inserted] {shard.table.try_emplace_with_hash(key, hash)};
+				std::invoke(std::forward<Fn>(fn), iter->second);
+				return inserted;
+			}
+		};
+
+		template <typename T, typename Hasher = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+		struct CombiningSet final : public details::FlatCombiningHashTable<Set<T, Hasher, KeyEqual>>
+		{
+		private:
+			using base_type = details::FlatCombiningHashTable<Set<T, Hasher, KeyEqual>>;
+		public:
+			using key_type = typename base_type::key_type;
+			using value_type = typename base_type::value_type;
+			using hasher = typename base_type::hasher;
+			using key_equal = typename base_type::key_equal;
+
+			using base_type::base_type;
+		};
+
+		template <typename Key, typename Value, typename Hasher = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+		struct CombiningMap final : public details::FlatCombiningHashTable<Map<Key, Value, Hasher, KeyEqual>>
+		{
+		private:
+			using base_type = details::FlatCombiningHashTable<Map<Key, Value, Hasher, KeyEqual>>;
+		public:
+			using key_type = typename base_type::key_type;
+			using mapped_type = Value;
+			using value_type = typename base_type::value_type;
+			using hasher = typename base_type::hasher;
+			using key_equal = typename base_type::key_equal;
+
+			using base_type::base_type;
+			using base_type::insert;
+
+			bool insert(Key const& key, Value value) {
+				return base_type::insert(value_type{key, std::move(value)});
+			}
+
+			/**
+			 * fn(Value&) on the existing value or on a default constructed one, inserted first.
+			 * Returns true if the key was inserted.
+			 * */
+			template <typename Fn>
+			requires std::default_initializable<Value> && std::invocable<Fn&, Value&>
+			bool upsert(Key const& key, Fn&& fn) {
+				return this->run([&key, &fn](typename base_type::Record &record) {
+					record.operation = base_type::Operation::Upsert;
+					record.key = &key;
+					record.context = std::addressof(fn);
+					record.updater = [](void* context, value_type& value) {
+						std::invoke(*static_cast<std::remove_reference_t<Fn>*>(context), value.second);
+					};
+				});
+			}
+		};
+
+		template <typename T, typename Hasher = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+		struct SingleWriterSet final : public details::SingleWriterHashTable<T, Hasher, KeyEqual, details::requirements::Type::Set>
+		{
+		private:
+			using base_type = details::SingleWriterHashTable<T, Hasher, KeyEqual, details::requirements::Type::Set>;
+		public:
+			using key_type = typename base_type::key_type;
+			using value_type = typename base_type::value_type;
+			using hasher = typename base_type::hasher;
+			using key_equal = typename base_type::key_equal;
+
+			using base_type::base_type;
+		};
+
+		template <typename Key, typename Value, typename Hasher = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+		struct SingleWriterMap final : public details::SingleWriterHashTable<std::pair<Key const, Value>, Hasher, KeyEqual, details::requirements::Type::Map>
+		{
+		private:
+			using base_type = details::SingleWriterHashTable<std::pair<Key const, Value>, Hasher, KeyEqual, details::requirements::Type::Map>;
+		public:
+			using key_type = typename base_type::key_type;
+			using mapped_type = Value;
+			using value_type = typename base_type::value_type;
+			using hasher = typename base_type::hasher;
+			using key_equal = typename base_type::key_equal;
+
+			using base_type::base_type;
+			using base_type::insert;
+
+			//readers side, a copy of the value
+			std::optional<Value> get(Key const& key) const {
+				std::optional<Value> result;
+				this->visit(key, [&result](value_type const& kv) { result.emplace(kv.second); });
+				return result;
+			}
+
+			//writer side
+			bool insert(Key const& key, Value value) {
+				return base_type::insert(value_type{key, std::move(value)});
+			}
+
+			/**
+			 * Readers see either the old value or the new one, the new one is published in a new node,
+			 * the old node is retired. Returns true if the key was inserted.
+			 * */
+			bool insert_or_assign(Key const& key, Value value) {
+				std::size_t const hash {this->hasher_(key)};
+				auto [slot, found] {this->probeForInsert(key, hash)};
+				value_type const* fresh {this->allocator.template new_object<value_type>(key, std::move(value))};
+				if (!found) {
+					slot->store(fresh);
+					++this->sz;
+					return true;
+				}
+				value_type const* previous {slot->load()};
+				slot->store(fresh);
+				this->retire(previous);
+				return false;
+			}
+		};
+
+		/**
+		 * Lock-free set of integral keys, insert and contains only, no erase. Keys are stored right in the index slots,
+		 * a slot is claimed by one CAS from the empty key, so inserts never wait for each other nor for a lock,
+		 * and a key never moves once it is in. Capacity is fixed at construction, as the index is never rebuilt —
+		 * it is sized for maxSize keys with the usual load factor; if it is overfilled anyway, insert() throws.
+		 * emptyKey marks a free slot, it can be inserted as well, it is just kept aside.
+		 * */
+		template <std::integral Key, typename Hasher = std::hash<Key>>
+		requires ::requirements::hash::IsHash<Key, Hasher, std::size_t>
+		class ConcurrentInsertOnlySet final {
+		public:
+			using key_type = Key;
+			using value_type = Key;
+			using hasher = Hasher;
+
+			static_assert(std::atomic<Key>::is_always_lock_free);
+
+			explicit ConcurrentInsertOnlySet(std::size_t maxSize, Key emptyKey_ = std::numeric_limits<Key>::max())
+				: mask {capacityFor(maxSize) - 1}
+				, slots {std::make_unique<std::atomic<Key>[]>(mask + 1)}
+				, emptyKey {emptyKey_}
+			{
+				for (std::size_t i {0}; i != capacity(); ++i) {
+					slots[i].store(emptyKey, std::memory_order_relaxed);
+				}
+			}
+
+			ConcurrentInsertOnlySet(ConcurrentInsertOnlySet const&) = delete;
+			ConcurrentInsertOnlySet& operator=(ConcurrentInsertOnlySet const&) = delete;
+
+			//true if the key is new, exactly one of the threads inserting the same key gets true
+			bool insert(Key key) {
+				if (key == emptyKey) {
+					return counted(!hasEmptyKey.exchange(true, std::memory_order_acq_rel));
+				}
+				std::size_t h {hasher_(key) & mask};
+				std::size_t const step {h | 1};
+				for (std::size_t i {0}; i != capacity(); ++i) {
+					Key current {slots[h].load(std::memory_order_acquire)};
+					if (current == emptyKey && slots[h].compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+						return counted(true);
+					}
+					//either it was taken already, or the CAS has lost and current is the winner
+					if (current == key) {
+						return false;
+					}
+					h = (h + step) & mask;
+				}
+				throw std::length_error("ConcurrentInsertOnlySet is full, consider larger maxSize");
+			}
+
+			bool contains(Key key) const {
+				if (key == emptyKey) {
+					return hasEmptyKey.load(std::memory_order_acquire);
+				}
+				std::size_t h {hasher_(key) & mask};
+				std::size_t const step {h | 1};
+				for (std::size_t i {0}; i != capacity(); ++i) {
+					Key const current {slots[h].load(std::memory_order_acquire)};
+					if (current == key) {
+						return true;
+					}
+					if (current == emptyKey) {
+						return false;
+					}
+					h = (h + step) & mask;
+				}
+				return false;
+			}
+
+			//keys inserted before the call are all visited, concurrent ones may be visited or not
+			template <typename Fn>
+			void for_each(Fn fn) const {
+				if (hasEmptyKey.load(std::memory_order_acquire)) {
+					fn(emptyKey);
+				}
+				for (std::size_t i {0}; i != capacity(); ++i) {
+					Key const current {slots[i].load(std::memory_order_acquire)};
+					if (current != emptyKey) {
+						fn(current);
+					}
+				}
+			}
+
+			std::size_t size() const {
+				std::size_t total {0};
+				for (Counter const &counter : counters) {
+					total += counter.value.load(std::memory_order_relaxed);
+				}
+				return total;
+			}
+
+			bool empty() const { return size() == 0; }
+
+			std::size_t capacity() const noexcept { return mask + 1; }
+
+		private:
+			//per stripe, so concurrent inserts don't meet on one counter
+			struct alignas(details::const_values::cacheLineSize) Counter {
+				std::atomic<std::size_t> value {0};
+			};
+
+			static std::size_t capacityFor(std::size_t maxSize) {
+				auto const required {static_cast<std::size_t>(static_cast<double>(maxSize) / details::const_values::maxLoadFactor)};
+				return std::bit_ceil(std::max(required + 1, details::const_values::initial_capacity));
+			}
+
+			bool counted(bool inserted) {
+				if (inserted) {
+					counters[details::threadStripe()].value.fetch_add(1, std::memory_order_relaxed);
+				}
+				return inserted;
+			}
+
+			std::size_t const mask;
+			std::unique_ptr<std::atomic<Key>[]> slots;
+			Key const emptyKey;
+			std::atomic<bool> hasEmptyKey {false};
+			std::array<Counter, details::const_values::readerStripes> counters {};
+			Hasher hasher_;
+		};
+
+		/**
+		 * Shard-per-thread map: every worker thread owns one partition, a regular Map with its own node pool,
+		 * and nobody else touches it — no locks around the table at all.
+		 * A request is routed by the hash of its key to the worker, and is passed through a SPSC ring;
+		 * a submitting thread always uses the same ring of the worker, picked by its stripe and claimed
+		 * for the time of a push, so the requests of one thread to one worker run in the order they came.
+		 * Results come back as std::future, or the request is a callback run on the worker thread.
+		 * */
+		template <typename Key, typename Value, typename Hasher = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+		class PartitionedMap final {
+		public:
+			using key_type = Key;
+			using mapped_type = Value;
+			using value_type = std::pair<Key const, Value>;
+			using hasher = Hasher;
+			using key_equal = KeyEqual;
+			using partition_type = Map<Key, Value, Hasher, KeyEqual>;
+
+			explicit PartitionedMap(std::size_t workerCount = std::max(std::thread::hardware_concurrency(), 1u), std::size_t queueCapacity = 1'024)
+				: workerBits {std::countr_zero(std::bit_ceil(std::max<std::size_t>(workerCount, 1)))}
+				, workers {std::make_unique<Worker[]>(std::size_t{1} << workerBits)}
+			{
+				for (Worker &worker : workerRange()) {
+					for (Lane &lane : worker.lanes) {
+						lane.ring.emplace(queueCapacity);
+					}
+				}
+				try {
+					for (Worker &worker : workerRange()) {
+						worker.thread = std::thread {[&worker] { run(worker); }};
+					}
+				}
+				catch (...) {
+					stop();
+					throw;
+				}
+			}
+
+			PartitionedMap(PartitionedMap const&) = delete;
+			PartitionedMap& operator=(PartitionedMap const&) = delete;
+
+			//the requests submitted before are all executed
+			~PartitionedMap() { stop(); }
+
+			std::size_t worker_count() const noexcept { return std::size_t{1} << workerBits; }
+
+			/**
+			 * fn(partition_type&) on the worker owning the key; the result, or the exception, is in the future.
+			 * */
+			template <typename Fn>
+			requires std::invocable<Fn&, partition_type&>
+			std::future<std::invoke_result_t<Fn&, partition_type&>> apply(Key const& key, Fn fn) {
+				return applyOn(workerFor(key), std::move(fn));
+			}
+
+			/**
+			 * Callback flavour, fn(partition_type&) is run on the worker owning the key and must not throw.
+			 * */
+			template <typename Fn>
+			requires std::invocable<Fn&, partition_type&>
+			void post(Key const& key, Fn fn) {
+				submit(workerFor(key), std::make_unique<Task<Fn>>(std::move(fn)));
+			}
+
+			std::future<bool> insert(Key key, Value value) {
+				Worker &worker {workerFor(key)};
+				return applyOn(worker, [element = value_type{std::move(key), std::move(value)}](partition_type &partition) mutable {
+					return partition.insert(std::move(element)).second;
+				});
+			}
+
+			std::future<bool> erase(Key key) {
+				Worker &worker {workerFor(key)};
+				return applyOn(worker, [key = std::move(key)](partition_type &partition) {
+					std::size_t const before {partition.size()};
+					partition.erase(key);
+					return partition.size() != before;
+				});
+			}
+
+			//a copy of the value, as the partition is not to be touched from outside
+			std::future<std::optional<Value>> find(Key key) {
+				Worker &worker {workerFor(key)};
+				return applyOn(worker, [key = std::move(key)](partition_type &partition) {
+					auto const found {std::as_const(partition).find(key)};
+					return found == partition.cend() ? std::optional<Value>{} : std::optional<Value>{found->second};
+				});
+			}
+
+			//asks every worker, so it is a sum of the partition sizes taken at slightly different moments
+			std::size_t size() {
+				std::vector<std::future<std::size_t>> sizes;
+				sizes.reserve(worker_count());
+				for (Worker &worker : workerRange()) {
+					sizes.push_back(applyOn(worker, [](partition_type &partition) { return partition.size(); }));
+				}
+				std::size_t total {0};
+				for (auto &size_ : sizes) {
+					total += size_.get();
+				}
+				return total;
+			}
+
+			bool empty() { return size() == 0; }
+
+		private:
+			struct TaskBase {
+				virtual ~TaskBase() = default;
+				virtual void run(partition_type &partition) = 0;
+			};
+
+			template <typename Fn>
+			struct Task final : TaskBase {
+				explicit Task(Fn fn_) : fn {std::move(fn_)} {}
+				void run(partition_type &partition) override { fn(partition); }
+				Fn fn;
+			};
+
+			using TaskPtr = std::unique_ptr<TaskBase>;
+
+			struct alignas(details::const_values::cacheLineSize) Lane {
+				//the producer side of the ring is owned by one thread at a time
+				std::atomic<bool> producer {false};
+				std::optional<details::SpscRing<TaskPtr>> ring;
+			};
+
+			struct Worker {
+				std::array<Lane, details::const_values::readerStripes> lanes;
+				alignas(details::const_values::cacheLineSize) std::atomic<std::uint32_t> signal {0};
+				std::atomic<bool> stopping {false};
+				std::thread thread;
+			};
+
+			template <typename Fn>
+			std::future<std::invoke_result_t<Fn&, partition_type&>> applyOn(Worker &worker, Fn fn) {
+				using Result = std::invoke_result_t<Fn&, partition_type&>;
+				std::packaged_task<Result(partition_type&)> task {std::move(fn)};
+				auto future {task.get_future()};
+				submit(worker, std::make_unique<Task<decltype(task)>>(std::move(task)));
+				return future;
+			}
+
+			//a full ring is a back pressure, the producer waits for the worker, it never goes to another ring
+			static void submit(Worker &worker, TaskPtr task) {
+				Lane &lane {worker.lanes[details::threadStripe()]};
+				while (true) {
+					//taken by another thread of the same stripe
+					if (lane.producer.load(std::memory_order_relaxed) || lane.producer.exchange(true, std::memory_order_acquire)) {
+						std::this_thread::yield();
+						continue;
+					}
+					bool const pushed {lane.ring->push(task)};
+					lane.producer.store(false, std::memory_order_release);
+					if (pushed) {
+						break;
+					}
+					std::this_thread::yield();
+				}
+				worker.signal.fetch_add(1, std::memory_order_release);
+				worker.signal.notify_one();
+			}
+
+			//the partition and its pool are created and used on the worker thread only
+			static void run(Worker &worker) {
+				pmr::PoolResource resource;
+				partition_type partition {0, &resource};
+				TaskPtr task;
+				while (true) {
+					std::uint32_t const seen {worker.signal.load(std::memory_order_acquire)};
+					//read before the drain, so everything submitted before stop() is drained
+					bool const stopping {worker.stopping.load(std::memory_order_acquire)};
+					bool idle {true};
+					for (Lane &lane : worker.lanes) {
+						while (lane.ring->pop(task)) {
+							task->run(partition);
+							task.reset();
+							idle = false;
+						}
+					}
+					if (idle) {
+						if (stopping) {
+							break;
+						}
+						worker.signal.wait(seen, std::memory_order_acquire);
+					}
+				}
+			}
+
+			void stop() {
+				for (Worker &worker : workerRange()) {
+					worker.stopping.store(true, std::memory_order_release);
+					worker.signal.fetch_add(1, std::memory_order_release);
+					worker.signal.notify_one();
+				}
+				for (Worker &worker : workerRange()) {
+					if (worker.thread.joinable()) {
+						worker.thread.join();
+					}
+				}
+			}
+
+			Worker& workerFor(Key const& key) {
+				if (workerBits == 0) {
+					return workers[0];
+				}
+				std::uint64_t const mixed {static_cast<std::uint64_t>(hasher_(key)) * 0x9E3779B97F4A7C15ull};
+				return workers[static_cast<std::size_t>(mixed >> (64 - workerBits))];
+			}
+
+			std::span<Worker> workerRange() { return {workers.get(), worker_count()}; }
+
+			int workerBits;
+			std::unique_ptr<Worker[]> workers;
+			Hasher hasher_;
+		};
+
+		/**
+		 * Map of key_fn(item) to Accumulator, each item is folded into its key's accumulator by combine_fn(acc, item),
+		 * the accumulator is default constructed first. Same result as the loop of combine_fn(map[key_fn(item)], item).
+		 * The input is radix-partitioned by the key hash, the parts are aggregated on threads into partial maps
+		 * with disjoint keys, so an accumulator sees its items in input order. The partials are merged at the end
+		 * by merge_unique_unchecked(), their nodes are placed into the index of the result on threads, no keys compared.
+		 * With nodes set to a thread safe resource, i.e. std::pmr::synchronized_pool_resource, the partials and
+		 * the result share it, and the nodes are just relinked; otherwise each partial has its own pool,
+		 * and the values are moved into the nodes of the result on the calling thread. key_fn is called twice per item,
+		 * key_fn and combine_fn are called from several threads at once.
+		 * */
+		template <typename Accumulator, std::ranges::random_access_range Range, typename KeyFn, typename CombineFn>
+		requires std::ranges::sized_range<Range> &&
+		std::invocable<KeyFn&, std::ranges::range_reference_t<Range>> &&
+		std::invocable<CombineFn&, Accumulator&, std::ranges::range_reference_t<Range>> &&
+		std::default_initializable<Accumulator>
+		auto group_by(Range &&range, KeyFn key_fn, CombineFn combine_fn,
+					  std::size_t threads = std::thread::hardware_concurrency(), std::pmr::memory_resource* nodes = nullptr)
+		{
+			using Key = std::remove_cvref_t<std::invoke_result_t<KeyFn&, std::ranges::range_reference_t<Range>>>;
+			using Result = Map<Key, Accumulator>;
+
+			auto const first {std::ranges::begin(range)};
+			std::size_t const count {static_cast<std::size_t>(std::ranges::size(range))};
+			std::size_t const chunks {details::parallel::chunksFor(threads, count, details::const_values::parallelMinChunk)};
+			Result result {nodes != nullptr ? Result{0, nodes} : Result{}};
+			if (chunks < 2) {
+				for (std::size_t i {0}; i != count; ++i) {
+					combine_fn(result[key_fn(first[i])], first[i]);
+				}
+				return result;
+			}
+
+			typename Result::hasher const hasher_ {};
+			int const partBits {details::parallel::partBitsFor(chunks)};
+			details::parallel::HashPartitions const partitioned {details::parallel::partitionByHash(chunks, count, partBits, [&](std::size_t i) {
+				return hasher_(key_fn(first[i]));
+			})};
+
+			//a part is aggregated by one thread, so partials have no keys in common
+			std::size_t const workers {std::min(chunks, std::size_t{1} << partBits)};
+			std::vector<std::unique_ptr<pmr::PoolResource>> pools;
+			std::vector<Result> partials;
+			partials.reserve(workers);
+			for (std::size_t worker {0}; worker != workers; ++worker) {
+				if (nodes == nullptr) {
+					pools.push_back(std::make_unique<pmr::PoolResource>());
+				}
+				partials.emplace_back(0, nodes != nullptr ? nodes : pools.back().get());
+			}
+			details::parallel::forChunks(workers, partitioned.start.size() - 1, [&](std::size_t worker, std::size_t begin, std::size_t end) {
+				Result &partial {partials[worker]};
+				for (std::size_t pos {partitioned.start[begin]}; pos != partitioned.start[end]; ++pos) {
+					std::size_t const i {partitioned.order[pos]};
+					combine_fn(partial[key_fn(first[i])], first[i]);
+				}
+			});
+
+			result.merge_unique_unchecked(partials, threads);
+			return result;
+		}
+
+	}//!namespace hash_table
+
+}//!namespace containers
@@ -4,19 +4,40 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <bit>
+#include <cassert>
 #include <climits>
 
 #include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
 #include <list>
 #include <variant>
 
 #include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
 #include <concepts>
 #include <type_traits>
+#include <memory>
 #include <memory_resource>
+#include <optional>
+#include <span>
 #include <stdexcept>
+#include <thread>
+#include <tuple>
 #include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 
 namespace requirements {
@@ -50,8 +71,61 @@ namespace containers {
 
 	namespace pmr {
 		    
+		/**
+		 * Resource that is able to give memory that is not in use anymore back to its upstream,
+		 * and to get memory for a number of blocks of the same size in advance.
+		 * Same non-virtual interface idiom as std::pmr::memory_resource.
+		 * */
+		class TrimmableMemoryResource : public std::pmr::memory_resource {
+		public:
+			//returns bytes given back to upstream
+			std::size_t trim() { return do_trim(); }
+			//returns bytes taken from upstream
+			std::size_t reserve(std::size_t bytes, std::size_t alignment, std::size_t count) { return do_reserve(bytes, alignment, count); }
+			//while on, blocks come from the untouched memory only, one after another, no freed block is reused
+			void freshBlocks(bool on) { do_fresh_blocks(on); }
+		protected:
+			virtual std::size_t do_trim() = 0;
+			virtual std::size_t do_reserve(std::size_t, std::size_t, std::size_t) { return 0; }
+			virtual void do_fresh_blocks(bool) {}
+		};
+
+		inline std::size_t trim(std::pmr::memory_resource* res) {
+			auto* trimmable {dynamic_cast<TrimmableMemoryResource*>(res)};
+			return trimmable ? trimmable->trim() : 0;
+		}
+
+		inline std::size_t reserve(std::pmr::memory_resource* res, std::size_t bytes, std::size_t alignment, std::size_t count) {
+			auto* trimmable {dynamic_cast<TrimmableMemoryResource*>(res)};
+			return trimmable ? trimmable->reserve(bytes, alignment, count) : 0;
+		}
+
+		//freshBlocks() for the scope's lifetime, if the resource is a trimmable one
+		class FreshBlocksScope final {
+		public:
+			explicit FreshBlocksScope(std::pmr::memory_resource* res)
+				: trimmable {dynamic_cast<TrimmableMemoryResource*>(res)}
+			{
+				if (trimmable) {
+					trimmable->freshBlocks(true);
+				}
+			}
+
+			FreshBlocksScope(FreshBlocksScope const&) = delete;
+			FreshBlocksScope& operator=(FreshBlocksScope const&) = delete;
+
+			~FreshBlocksScope() {
+				if (trimmable) {
+					trimmable->freshBlocks(false);
+				}
+			}
+
+		private:
+			TrimmableMemoryResource* trimmable;
+		};
+
 		template <std::size_t Alignment>
-		class AlignedMemoryResource final : public std::pmr::memory_resource {
+		class AlignedMemoryResource final : public TrimmableMemoryResource {
 		public:
 			explicit AlignedMemoryResource(std::pmr::memory_resource* upstream)
 				: upstream_resource(upstream) 
@@ -75,12 +149,367 @@ namespace containers {
 				auto const* other_ptr {dynamic_cast<const AlignedMemoryResource*>(&other)};
 				return other_ptr && upstream_resource->is_equal(*other_ptr->upstream_resource);
 			}
+
+			std::size_t do_trim() override {
+				return pmr::trim(upstream_resource);
+			}
+
+			std::size_t do_reserve(std::size_t bytes, std::size_t alignment, std::size_t count) override {
+				return pmr::reserve(upstream_resource, bytes, std::max(alignment, Alignment), count);
+			}
+
+			void do_fresh_blocks(bool on) override {
+				if (auto* trimmable {dynamic_cast<TrimmableMemoryResource*>(upstream_resource)}) {
+					trimmable->freshBlocks(on);
+				}
+			}
+		private:
+			std::pmr::memory_resource* upstream_resource;
+		};
+
+#if defined(__linux__)
+		/**
+		 * Takes memory straight from mmap, asking for transparent huge pages, so big index arrays and
+		 * node pools need much less TLB entries. Every allocation is a separate mapping, therefore it is meant
+		 * to be either used for an index directly, or to be an upstream for a pool resource, ie
+		 * std::pmr::unsynchronized_pool_resource nodes {&hugePages}.
+		 * With prefault set, pages are touched right away, so there is no first-touch page faults later on.
+		 * */
+		class HugePageMemoryResource final : public std::pmr::memory_resource {
+		public:
+			static constexpr std::size_t hugePageSize {1ull << 21};
+
+			explicit HugePageMemoryResource(bool prefault = false)
+				: prefault (prefault)
+			{}
+
+			bool prefaults() const noexcept { return prefault; }
+
+		protected:
+			void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+				std::size_t const
+					size {mappingSize(bytes)},
+					align {mappingAlignment(bytes, alignment)},
+					extra {align > pageSize() ? align : 0};
+
+				void* raw {mmap(nullptr, size + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+				if (raw == MAP_FAILED) {
+					throw std::bad_alloc();
+				}
+				auto* p {static_cast<std::byte*>(raw)};
+				if (extra) {
+					auto* aligned {reinterpret_cast<std::byte*>((reinterpret_cast<std::uintptr_t>(p) + align - 1) & ~(align - 1))};
+					if (std::size_t const head {static_cast<std::size_t>(aligned - p)}; head) {
+						munmap(p, head);
+					}
+					if (std::size_t const tail {extra - static_cast<std::size_t>(aligned - p)}; tail) {
+						munmap(aligned + size, tail);
+					}
+					p = aligned;
+				}
+				if (size >= hugePageSize) {
+					//advisory only, it is fine if THP are switched off
+					madvise(p, size, MADV_HUGEPAGE);
+				}
+				if (prefault) {
+					//populating after madvise, otherwise MAP_POPULATE would fault it in with regular pages
+#if defined(MADV_POPULATE_WRITE)
+					if (madvise(p, size, MADV_POPULATE_WRITE) != 0)
+#endif
+					{
+						for (std::size_t offset {0}; offset < size; offset += pageSize()) {
+							*static_cast<volatile std::byte*>(p + offset) = std::byte{0};
+						}
+					}
+				}
+				return p;
+			}
+
+			void do_deallocate(void* p, std::size_t bytes, [[maybe_unused]] std::size_t alignment) override {
+				munmap(p, mappingSize(bytes));
+			}
+
+			bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+				return this == &other;
+			}
+
+		private:
+			bool prefault;
+
+			static std::size_t pageSize() noexcept {
+				static std::size_t const sz {static_cast<std::size_t>(sysconf(_SC_PAGESIZE))};
+				return sz;
+			}
+
+			static std::size_t mappingSize(std::size_t bytes) noexcept {
+				std::size_t const granularity {bytes >= hugePageSize ? hugePageSize : pageSize()};
+				return (bytes + granularity - 1) & ~(granularity - 1);
+			}
+
+			static std::size_t mappingAlignment(std::size_t bytes, std::size_t alignment) noexcept {
+				return bytes >= hugePageSize ? std::max(alignment, hugePageSize) : alignment;
+			}
+		};
+#endif
+
+		/**
+		 * Unsynchronized pool of power of two sized blocks, same idea as std::pmr::unsynchronized_pool_resource,
+		 * but every chunk counts its blocks in use, so the chunks that got empty can be returned upstream by trim().
+		 * Chunks are asked from upstream with natural alignment, or the one of the request if it is bigger,
+		 * and a block finds its chunk by a binary search over the chunks sorted by address.
+		 * With sizeAlignedChunks chunks are aligned to their size instead, so a block finds its chunk by masking
+		 * its address, and blocks never cross the boundary of their size; upstream is to cope with such alignment.
+		 * Requests for blocks bigger than chunkSize / 16 go straight to upstream.
+		 * */
+		class PoolResource final : public TrimmableMemoryResource {
+		public:
+			static constexpr std::size_t defaultChunkSize {1 << 16};
+
+			explicit PoolResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource(),
+								  std::size_t chunkSize = defaultChunkSize,
+								  bool sizeAlignedChunks = false)
+				: upstream_resource (upstream)
+				, chunkSize (std::bit_ceil(std::max(chunkSize, minChunkSize)))
+				, maxBlockSize (this->chunkSize >> 4)
+				, sizeAligned (sizeAlignedChunks)
+			{}
+
+			PoolResource(PoolResource const&) = delete;
+			PoolResource& operator=(PoolResource const&) = delete;
+
+			~PoolResource() override { release(); }
+
+			//gives back all the chunks, even if there are blocks in use
+			void release() {
+				for (Bucket &bucket : buckets) {
+					for (Chunk* list : {bucket.partial, bucket.full}) {
+						while (list) {
+							Chunk* next {list->next};
+							upstream_resource->deallocate(list, chunkSize, list->alignment);
+							list = next;
+						}
+					}
+					bucket = Bucket{};
+				}
+				chunkIndex.clear();
+				chunksHeld = 0;
+			}
+
+			std::size_t chunks() const noexcept { return chunksHeld; }
+
+			std::size_t bytesHeld() const noexcept { return chunksHeld * chunkSize; }
+
+			std::pmr::memory_resource* upstream() const noexcept { return upstream_resource; }
+
+			bool sizeAlignedChunks() const noexcept { return sizeAligned; }
+
+		protected:
+			void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+				std::size_t const blockSize {blockSizeFor(bytes, alignment)};
+				if (blockSize > maxBlockSize) {
+					return upstream_resource->allocate(bytes, alignment);
+				}
+				Bucket &bucket {buckets[std::bit_width(blockSize)]};
+				Chunk* chunk {fresh ? bucket.fresh : bucket.partial};
+				if (!fresh) {
+					//an over-aligned request skips the chunks that are aligned less than it needs
+					while (chunk && !alignedFor(chunk, alignment)) {
+						chunk = chunk->next;
+					}
+				}
+				if (!chunk || !alignedFor(chunk, alignment) || (fresh && chunk->bumpOffset + blockSize > chunkSize)) {
+					chunk = makeChunk(blockSize, alignment);
+					push(bucket.partial, chunk);
+					if (fresh) {
+						bucket.fresh = chunk;
+					}
+				}
+				void* p;
+				if (chunk->freeList && !fresh) {
+					p = chunk->freeList;
+					chunk->freeList = *static_cast<void**>(p);
+				}
+				else {
+					p = reinterpret_cast<std::byte*>(chunk) + chunk->bumpOffset;
+					chunk->bumpOffset += blockSize;
+				}
+				++chunk->used;
+				--bucket.available;
+				if (isFull(chunk)) {
+					unlink(bucket.partial, chunk);
+					push(bucket.full, chunk);
+				}
+				return p;
+			}
+
+			void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+				std::size_t const blockSize {blockSizeFor(bytes, alignment)};
+				if (blockSize > maxBlockSize) {
+					upstream_resource->deallocate(p, bytes, alignment);
+					return;
+				}
+				Bucket &bucket {buckets[std::bit_width(blockSize)]};
+				Chunk* chunk {chunkOf(p)};
+				if (isFull(chunk)) {
+					unlink(bucket.full, chunk);
+					push(bucket.partial, chunk);
+				}
+				*static_cast<void**>(p) = chunk->freeList;
+				chunk->freeList = p;
+				--chunk->used;
+				++bucket.available;
+			}
+
+			bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+				return this == &other;
+			}
+
+			std::size_t do_trim() override {
+				std::size_t released {0};
+				for (Bucket &bucket : buckets) {
+					Chunk* chunk {bucket.partial};
+					while (chunk) {
+						Chunk* next {chunk->next};
+						if (chunk->used == 0) {
+							if (chunk == bucket.fresh) {
+								bucket.fresh = nullptr;
+							}
+							unlink(bucket.partial, chunk);
+							bucket.available -= chunk->capacity;
+							unindexChunk(chunk);
+							upstream_resource->deallocate(chunk, chunkSize, chunk->alignment);
+							released += chunkSize;
+							--chunksHeld;
+						}
+						chunk = next;
+					}
+				}
+				return released;
+			}
+
+			std::size_t do_reserve(std::size_t bytes, std::size_t alignment, std::size_t count) override {
+				std::size_t const blockSize {blockSizeFor(bytes, alignment)};
+				if (blockSize > maxBlockSize) {
+					return 0;
+				}
+				Bucket &bucket {buckets[std::bit_width(blockSize)]};
+				std::size_t reserved {0};
+				while (bucket.available < count) {
+					push(bucket.partial, makeChunk(blockSize, alignment));
+					reserved += chunkSize;
+				}
+				return reserved;
+			}
+
+			//a chunk per block size is bumped through, taken fresh from upstream
+			void do_fresh_blocks(bool on) override {
+				fresh = on;
+				for (Bucket &bucket : buckets) {
+					bucket.fresh = nullptr;
+				}
+			}
+
 		private:
+			static constexpr std::size_t minBlockSize {sizeof(void*) * 2};
+			static constexpr std::size_t minChunkSize {1 << 12};
+
+			struct Chunk {
+				Chunk* prev;
+				Chunk* next;
+				void* freeList;
+				std::size_t bumpOffset;
+				std::size_t used;
+				std::size_t capacity;
+				//the one it was asked from upstream with
+				std::size_t alignment;
+			};
+
+			struct Bucket {
+				Chunk* partial {nullptr};
+				Chunk* full {nullptr};
+				std::size_t available {0};
+				//the chunk fresh blocks are bumped from
+				Chunk* fresh {nullptr};
+			};
+
 			std::pmr::memory_resource* upstream_resource;
+			std::size_t chunkSize;
+			std::size_t maxBlockSize;
+			std::size_t chunksHeld {0};
+			bool fresh {false};
+			bool sizeAligned;
+			std::array<Bucket, sizeof(std::size_t) * CHAR_BIT + 1> buckets {};
+			//all the chunks sorted by address, unless they are size aligned; bookkeeping, not from upstream
+			std::vector<Chunk*> chunkIndex;
+
+			static std::size_t blockSizeFor(std::size_t bytes, std::size_t alignment) noexcept {
+				return std::bit_ceil(std::max({bytes, alignment, minBlockSize}));
+			}
+
+			static bool isFull(Chunk const* chunk) noexcept { return chunk->used == chunk->capacity; }
+
+			static bool alignedFor(Chunk const* chunk, std::size_t alignment) noexcept {
+				//blocks are at multiples of their size from the chunk, that is a multiple of the alignment
+				return (reinterpret_cast<std::uintptr_t>(chunk) & (alignment - 1)) == 0;
+			}
+
+			Chunk* makeChunk(std::size_t blockSize, std::size_t alignment) {
+				std::size_t const chunkAlignment {sizeAligned ? chunkSize : std::max(alignment, alignof(std::max_align_t))};
+				if (!sizeAligned) {
+					chunkIndex.reserve(chunkIndex.size() + 1);
+				}
+				void* raw {upstream_resource->allocate(chunkSize, chunkAlignment)};
+				std::size_t const headerSpan {(sizeof(Chunk) + blockSize - 1) & ~(blockSize - 1)};
+				auto* chunk {::new (raw) Chunk{nullptr, nullptr, nullptr, headerSpan, 0, (chunkSize - headerSpan) / blockSize, chunkAlignment}};
+				if (!sizeAligned) {
+					chunkIndex.insert(std::upper_bound(chunkIndex.begin(), chunkIndex.end(), chunk, std::less<Chunk*>{}), chunk);
+				}
+				buckets[std::bit_width(blockSize)].available += chunk->capacity;
+				++chunksHeld;
+				return chunk;
+			}
+
+			Chunk* chunkOf(void* p) const noexcept {
+				if (sizeAligned) {
+					return reinterpret_cast<Chunk*>(reinterpret_cast<std::uintptr_t>(p) & ~(chunkSize - 1));
+				}
+				//the last chunk that starts at p or before
+				auto const next {std::upper_bound(chunkIndex.begin(), chunkIndex.end(), p, [](void* ptr, Chunk* chunk) {
+					return std::less<void const*>{}(ptr, chunk);
+				})};
+				return *std::prev(next);
+			}
+
+			void unindexChunk(Chunk* chunk) noexcept {
+				if (!sizeAligned) {
+					chunkIndex.erase(std::lower_bound(chunkIndex.begin(), chunkIndex.end(), chunk, std::less<Chunk*>{}));
+				}
+			}
+
+			static void push(Chunk* &head, Chunk* chunk) noexcept {
+				chunk->prev = nullptr;
+				chunk->next = head;
+				if (head) {
+					head->prev = chunk;
+				}
+				head = chunk;
+			}
+
+			static void unlink(Chunk* &head, Chunk* chunk) noexcept {
+				if (chunk->prev) {
+					chunk->prev->next = chunk->next;
+				}
+				else {
+					head = chunk->next;
+				}
+				if (chunk->next) {
+					chunk->next->prev = chunk->prev;
+				}
+			}
 		};
 
 		// static inline std::pmr::synchronized_pool_resource resource(std::pmr::get_default_resource());
-		static inline std::pmr::unsynchronized_pool_resource resource(std::pmr::get_default_resource());
+		static inline PoolResource resource(std::pmr::get_default_resource());
 		// using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
 		// usage example
 		// std::pmr::list<int> l(pmr::allocator_type{&pmr::resource});
@@ -105,9 +534,134 @@ namespace containers {
 				constexpr inline double maxLoadFactor {0.5};
 				constexpr inline double minLoadFactor {0.125};
 				constexpr inline int maxEmplaceAttempts {5};
+				constexpr inline std::size_t findManyGroup {16};
+				constexpr inline int bulkRegionBits {12};
+				//smallest piece of work worth a thread
+				constexpr inline std::size_t parallelMinChunk {1<<14};
+				//partitions per thread of the parallel build, so a few heavy partitions don't hold the others
+				constexpr inline std::size_t parallelPartitionsPerThread {8};
 
 			}//!namespace details::const_values
 
+			namespace parallel {
+
+				//as many chunks as threads, but no less than minChunk items per chunk, at least one chunk
+				inline std::size_t chunksFor(std::size_t threads, std::size_t count, std::size_t minChunk) {
+					return std::clamp<std::size_t>(count / std::max<std::size_t>(minChunk, 1), 1, std::max<std::size_t>(threads, 1));
+				}
+
+				//first item of the chunk, when count items are split into chunks as evenly as possible
+				inline std::size_t chunkBound(std::size_t chunk, std::size_t chunks, std::size_t count) {
+					return count / chunks * chunk + std::min(chunk, count % chunks);
+				}
+
+				/**
+				 * fn(chunk, begin, end) for each of the chunks of [0, count), chunks are contiguous and in order.
+				 * The calling thread takes the first chunk. The first exception is rethrown once all of them are done.
+				 * */
+				template <typename Fn>
+				void forChunks(std::size_t chunks, std::size_t count, Fn &&fn) {
+					auto bound = [chunks, count](std::size_t chunk) { return chunkBound(chunk, chunks, count); };
+					std::vector<std::exception_ptr> errors (chunks);
+					auto run = [&](std::size_t chunk) {
+						try {
+							fn(chunk, bound(chunk), bound(chunk + 1));
+						}
+						catch (...) {
+							errors[chunk] = std::current_exception();
+						}
+					};
+					std::vector<std::thread> threads;
+					threads.reserve(chunks - 1);
+					try {
+						for (std::size_t chunk {1}; chunk < chunks; ++chunk) {
+							threads.emplace_back(run, chunk);
+						}
+					}
+					catch (...) {
+						//no thread to spare, the rest is done right here
+						for (std::size_t chunk {threads.size() + 1}; chunk < chunks; ++chunk) {
+							run(chunk);
+						}
+					}
+					run(0);
+					for (std::thread &thread : threads) {
+						thread.join();
+					}
+					for (std::exception_ptr const& error : errors) {
+						if (error) {
+							std::rethrow_exception(error);
+						}
+					}
+				}
+
+				/**
+				 * fn(task) for each of [0, count), threads take the tasks one at a time off a shared counter,
+				 * so the ones that got the light tasks go on with the rest, instead of waiting for a slow one.
+				 * */
+				template <typename Fn>
+				void forTasks(std::size_t threads, std::size_t count, Fn &&fn) {
+					std::atomic<std::size_t> next {0};
+					std::size_t const workers {std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(count, 1))};
+					forChunks(workers, workers, [&next, &fn, count](std::size_t, std::size_t, std::size_t) {
+						for (std::size_t task {next.fetch_add(1, std::memory_order_relaxed)}; task < count; task = next.fetch_add(1, std::memory_order_relaxed)) {
+							fn(task);
+						}
+					});
+				}
+
+				//spreads the hash over the high bits, where the parts are taken from
+				inline std::uint64_t mix(std::size_t hash) {
+					return static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+				}
+
+				//bits of the part number, so there are several parts per chunk
+				inline int partBitsFor(std::size_t chunks) {
+					return static_cast<int>(std::bit_width(std::bit_ceil(chunks * const_values::parallelPartitionsPerThread))) - 1;
+				}
+
+				struct HashPartitions {
+					std::vector<std::size_t> hashes;
+					//items part by part, in input order inside a part
+					std::vector<std::size_t> order;
+					//part p is order[start[p], start[p + 1])
+					std::vector<std::size_t> start;
+				};
+
+				/**
+				 * Items [0, count) are hashed by hashOf(i) and radix-partitioned into 2^bits parts
+				 * by the high bits of the mixed hash; both passes are split into chunks over threads.
+				 * */
+				template <typename HashOf>
+				HashPartitions partitionByHash(std::size_t chunks, std::size_t count, int bits, HashOf &&hashOf) {
+					std::size_t const parts {std::size_t{1} << bits};
+					auto partOf = [bits](std::size_t hash) { return static_cast<std::size_t>(mix(hash) >> (64 - bits)); };
+					HashPartitions result {std::vector<std::size_t>(count), std::vector<std::size_t>(count), std::vector<std::size_t>(parts + 1, 0)};
+					std::vector<std::vector<std::size_t>> offsets (chunks, std::vector<std::size_t>(parts, 0));
+					forChunks(chunks, count, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+						for (std::size_t i {begin}; i != end; ++i) {
+							result.hashes[i] = hashOf(i);
+							++offsets[chunk][partOf(result.hashes[i])];
+						}
+					});
+					//part by part, chunk by chunk inside, so each part keeps input order
+					for (std::size_t part {0}, running {0}; part != parts; ++part) {
+						result.start[part] = running;
+						for (std::vector<std::size_t> &chunkOffsets : offsets) {
+							running += std::exchange(chunkOffsets[part], running);
+						}
+						result.start[part + 1] = running;
+					}
+					forChunks(chunks, count, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+						for (std::size_t i {begin}; i != end; ++i) {
+							result.order[offsets[chunk][partOf(result.hashes[i])]++] = i;
+						}
+					});
+					return result;
+				}
+
+			}//!namespace details::parallel
+
 			class CapacityPolicy {
 			public:
 
@@ -119,6 +673,12 @@ namespace containers {
 				std::size_t capacity() const { return capacity_; }
 				std::size_t mask() const { return mask_; }
 
+				//no index at all, as a moved-from table has, one is allocated by the next insert
+				void clear() noexcept {
+					capacity_ = 0;
+					mask_ = 0;
+				}
+
 				void setCapacity(std::size_t newCapacity) noexcept {
 					if (not isPowerOfTwo(newCapacity)) {
 						newCapacity = std::bit_ceil(newCapacity);
@@ -152,17 +712,53 @@ namespace containers {
 				enum class Type : std::uint8_t {
 					Set = 0,
 					Map = 1,
+					MultiSet = 2,
+					MultiMap = 3,
 				};
 
+				//map and set here are about the layout of a value, keys may be unique or not
 				template<Type t>
-				concept IsMapConcept = requires { requires t == Type::Map; };				
+				concept IsMapConcept = requires { requires t == Type::Map || t == Type::MultiMap; };
 				template<Type t>
-				static constexpr inline bool is_map_v {t == Type::Map};
+				static constexpr inline bool is_map_v {t == Type::Map || t == Type::MultiMap};
 
 				template<Type t>
-				concept IsSetConcept = requires { requires t == Type::Set; };
+				concept IsSetConcept = requires { requires t == Type::Set || t == Type::MultiSet; };
 				template<Type t>
-				static constexpr inline bool is_set_v {t == Type::Set};
+				static constexpr inline bool is_set_v {t == Type::Set || t == Type::MultiSet};
+
+				template<Type t>
+				concept IsUniqueConcept = requires { requires t == Type::Set || t == Type::Map; };
+				template<Type t>
+				static constexpr inline bool is_multi_v {t == Type::MultiSet || t == Type::MultiMap};
+
+				template<typename Hasher, typename KeyEqual>
+				concept IsTransparentConcept = requires {
+					typename Hasher::is_transparent;
+					typename KeyEqual::is_transparent;
+				};
+
+				//either the key itself, or anything transparent hasher and key_equal can deal with
+				template<typename K, typename Key, typename Hasher, typename KeyEqual>
+				concept IsLookupKeyConcept =
+					std::same_as<std::remove_cvref_t<K>, std::remove_cvref_t<Key>> ||
+					(
+						IsTransparentConcept<Hasher, KeyEqual> &&
+						std::is_invocable_r_v<std::size_t, Hasher const&, K const&> &&
+						std::predicate<KeyEqual const&, Key const&, K const&>
+					);
+
+				template<typename... Args>
+				struct IsIteratorPair : std::false_type {};
+
+				template<typename First, typename Second>
+				struct IsIteratorPair<First, Second> : std::bool_constant<
+					std::input_iterator<std::remove_cvref_t<First>> &&
+					std::sentinel_for<std::remove_cvref_t<Second>, std::remove_cvref_t<First>>
+				> {};
+
+				template<typename... Args>
+				static constexpr inline bool is_iterator_pair_v {IsIteratorPair<Args...>::value};
 
 			}//!namespace details::requirements
 
@@ -241,6 +837,56 @@ namespace containers {
 				using reverse_iterator = typename Data::reverse_iterator;
 				using const_reverse_iterator = typename Data::const_reverse_iterator;
 
+				/**
+				 * Owns an element taken out of a table, it stays in its own list node.
+				 * Between the tables that share a memory resource the node is just relinked,
+				 * so the value is neither copied nor moved and keeps its address.
+				 * */
+				class node_type final {
+				public:
+					node_type() = default;
+					node_type(node_type&& other) noexcept : node {std::move(other.node)} { other.node.reset(); }
+					node_type& operator=(node_type&& other) noexcept {
+						if (this != &other) {
+							//list move assignment would move the values if resources differ, so the list is rebuilt instead
+							node.reset();
+							if (other.node.has_value()) {
+								node.emplace(std::move(*other.node));
+							}
+							other.node.reset();
+						}
+						return *this;
+					}
+
+					[[nodiscard]] bool empty() const noexcept { return !node.has_value() || node->empty(); }
+					explicit operator bool() const noexcept { return !empty(); }
+
+					T& value() const
+					requires requirements::IsSetConcept<type>
+					{ return node->front(); }
+
+					key_type const& key() const
+					requires requirements::IsMapConcept<type>
+					{ return node->front().first; }
+
+					MappedType& mapped() const
+					requires requirements::IsMapConcept<type>
+					{ return node->front().second; }
+
+				private:
+					friend HashTable;
+
+					explicit node_type(pmr::allocator_type<T> allocator) : node {std::in_place, allocator} {}
+
+					mutable std::optional<Data> node;
+				};
+
+				struct insert_return_type {
+					iterator position;
+					bool inserted;
+					node_type node;
+				};
+
 			private:
 
 				template <std::input_iterator IterType>
@@ -264,8 +910,28 @@ namespace containers {
 					void reset() noexcept { state_ = State::Deleted; }
 				};
 
+				/**
+				 * Multi tables index a key once, the slot refers to the first of equal keys' nodes,
+				 * those are kept adjacent in the list, so equal_range() is one probe and a walk.
+				 * */
+				static constexpr bool multiKeys {requirements::is_multi_v<type>};
+
+				//trivially destructible values can be overwritten in place, so their erased nodes are worth reusing
+				static constexpr bool recyclableNodes {std::is_trivially_destructible_v<T> && std::is_nothrow_move_constructible_v<T>};
+
+				template <typename K>
+				static constexpr bool is_lookup_key_v {requirements::IsLookupKeyConcept<K, key_type, Hasher, KeyEqual>};
+
+				template <typename K>
+				static constexpr bool is_transparent_lookup_v {
+					is_lookup_key_v<K> &&
+					!std::same_as<std::remove_cvref_t<K>, std::remove_cv_t<key_type>> &&
+					!std::is_convertible_v<K const&, const_iterator> &&
+					!std::is_convertible_v<K const&, iterator>
+				};
+
 				struct Access final {
-					using AccessHelper = typename std::vector<Element<iterator>>;
+					using AccessHelper = typename std::pmr::vector<Element<iterator>>;
 					using AccessIter = typename AccessHelper::iterator;
 					using AccessCIter = typename AccessHelper::const_iterator;
 
@@ -276,59 +942,96 @@ namespace containers {
 					CapacityPolicy capacityPolicy;
 					std::size_t sz;
 					std::size_t deleted_count;
+					std::size_t epoch;
+					std::size_t autoTrimFrom;
+					//erase() leaves shrinks and tombstone purges to maintain()
+					bool deferredMaintenance;
+					//rehash of this many elements or more is done on rehashThreads, 0 is never
+					std::size_t parallelRehashFrom;
+					std::size_t rehashThreads;
 
 					Hasher hasher;
 					KeyEqual equal;
 					KeyExtractor keyExtractor;
 
-					explicit Access(Data &data, std::pmr::memory_resource* res)
+					explicit Access(Data &data, std::pmr::memory_resource* res, std::pmr::memory_resource* indexRes)
 						: memResourcePtr(res)
 						, data(data)
 						, deadNodes(pmr::allocator_type<T>{res})
+						, accessHelper(indexRes)
 						, capacityPolicy {0, sizeof(T)}
 						, sz {0}
 						, deleted_count{0}
+						, epoch {0}
+						, autoTrimFrom {0}
+						, deferredMaintenance {false}
+						, parallelRehashFrom {0}
+						, rehashThreads {1}
 					{
 						accessHelper.resize(capacityPolicy.capacity());
 					}
 
-					explicit Access(Data &data, std::size_t initialCapacity, std::pmr::memory_resource* res)
+					explicit Access(Data &data, std::size_t initialCapacity, std::pmr::memory_resource* res, std::pmr::memory_resource* indexRes)
 						: memResourcePtr(res)
 						, data(data)
 						, deadNodes(pmr::allocator_type<T>{res})
+						, accessHelper(indexRes)
 						, capacityPolicy {initialCapacity, sizeof(T)}
 						, sz {0}
 						, deleted_count{0}
+						, epoch {0}
+						, autoTrimFrom {0}
+						, deferredMaintenance {false}
+						, parallelRehashFrom {0}
+						, rehashThreads {1}
 					{
 						accessHelper.resize(capacityPolicy.capacity());
 					}
 
-					AccessIter getElemIter(key_type const &key) {
-						std::size_t const 
-							cap{capacityPolicy.capacity()},
-							mask {capacityPolicy.mask()};
-					    std::size_t h {hasher(key) & mask};
-					    std::size_t const step {h | 1};
-					
-					    auto check = [this, &key](std::size_t idx) __attribute__((always_inline)) -> bool {
-					        return accessHelper[idx].is_free() ||
-					               (accessHelper[idx].has_value() && equal(keyExtractor(*(accessHelper[idx].value())), key));
-					    };
-					
-						for (std::size_t i {0}; i != cap; ++i) {
-							if (check(h)) {
-					            return accessHelper.begin() + h;
-					        }
-					        h = (h + step) & mask;
-						}
-					    return accessHelper.end();
+					//takes the nodes' index and the settings of other, no allocations, other is left without an index
+					explicit Access(Data &data, Access &&other) noexcept
+						: memResourcePtr(other.memResourcePtr)
+						, data(data)
+						, deadNodes(pmr::allocator_type<T>{memResourcePtr})
+						, accessHelper(std::move(other.accessHelper))
+						, capacityPolicy {other.capacityPolicy}
+						, sz {other.sz}
+						, deleted_count{other.deleted_count}
+						, epoch {0}
+						, autoTrimFrom {other.autoTrimFrom}
+						, deferredMaintenance {other.deferredMaintenance}
+						, parallelRehashFrom {other.parallelRehashFrom}
+						, rehashThreads {other.rehashThreads}
+					{
+						other.reset();
+					}
+
+					template <typename K>
+					requires is_lookup_key_v<K>
+					AccessIter getElemIter(K const &key) {
+						return getElemIter(key, hasher(key));
+					}
+
+					template <typename K>
+					requires is_lookup_key_v<K>
+					AccessCIter getElemIter(K const &key) const {
+						return getElemIter(key, hasher(key));
+					}
+
+					template <typename K>
+					requires is_lookup_key_v<K>
+					AccessIter getElemIter(K const &key, std::size_t hash) {
+						AccessCIter const found {std::as_const(*this).getElemIter(key, hash)};
+						return accessHelper.begin() + (found - accessHelper.cbegin());
 					}
 
-					AccessCIter getElemIter(key_type const &key) const {
+					template <typename K>
+					requires is_lookup_key_v<K>
+					AccessCIter getElemIter(K const &key, std::size_t hash) const {
 						std::size_t const 
 							cap{capacityPolicy.capacity()},
 							mask {capacityPolicy.mask()};
-					    std::size_t h {hasher(key) & mask};
+					    std::size_t h {hash & mask};
 					    std::size_t const step {h | 1};
 					
 					    auto check = [this, &key](std::size_t idx) __attribute__((always_inline)) -> bool {
@@ -345,58 +1048,673 @@ namespace containers {
 					    return accessHelper.cend();
 					}
 
-					iterator find(key_type const &key) {
-						AccessIter elemIter {getElemIter(key)};
-						return contains(elemIter) ? elemIter->value() : data.end();
-					}
-
-					const_iterator find(key_type const &key) const {
-						AccessCIter elemIter {getElemIter(key)};
-						return contains(elemIter) ? elemIter->value() : data.end();
-					}
-
-					std::pair<iterator, bool> insert(T mappedValue){
-
-						auto emplaceable = [this](AccessIter iter) -> bool {
-							return iter != accessHelper.end() && iter->is_free();
+					/**
+					 * AMAC-style lookups: up to findManyGroup lookups are in flight, each one is a tiny state machine,
+					 * that makes one step per round — either reads an index slot or compares the key in a node,
+					 * both prefetched a round before, and then prefetches whatever it needs for the next step.
+					 * So cache misses of different keys overlap along the whole probe sequence, not just the first slot.
+					 * */
+					template <typename Emit>
+					void findMany(std::span<key_type const> keys, Emit &emit) const {
+						struct Lookup {
+							std::size_t idx;
+							std::size_t h;
+							std::size_t step;
+							std::size_t probes;
+							bool atNode;
 						};
+						static constexpr std::size_t done {std::numeric_limits<std::size_t>::max()};
+						std::size_t const
+							cap {capacityPolicy.capacity()},
+							mask {capacityPolicy.mask()};
+						if (cap == 0) {
+							for (std::size_t i {0}; i != keys.size(); ++i) {
+								emit(i, data.cend());
+							}
+							return;
+						}
+						std::array<Lookup, const_values::findManyGroup> inFlight;
+						std::size_t next {0}, active {0};
 
-						auto place_to_data = [this](T mappedValue) -> iterator {
-						    data.emplace_back(
-						        std::make_obj_using_allocator<T>(
-						            pmr::allocator_type<T>{memResourcePtr},
-						            std::move(mappedValue)
-						        )
-						    );
-						    ++sz;
-						    return std::prev(data.end());
+						auto start = [&](Lookup &lookup) {
+							if (next == keys.size()) {
+								lookup.idx = done;
+								return false;
+							}
+							lookup.idx = next++;
+							lookup.h = hasher(keys[lookup.idx]) & mask;
+							lookup.step = lookup.h | 1;
+							lookup.probes = 0;
+							lookup.atNode = false;
+							__builtin_prefetch(accessHelper.data() + lookup.h);
+							return true;
+						};
+						auto finish = [&](Lookup &lookup, const_iterator found) {
+							emit(lookup.idx, found);
+							if (!start(lookup)) {
+								--active;
+							}
+						};
+						auto advance = [&](Lookup &lookup) {
+							lookup.atNode = false;
+							lookup.h = (lookup.h + lookup.step) & mask;
+							if (++lookup.probes == cap) {
+								finish(lookup, data.cend());
+								return;
+							}
+							__builtin_prefetch(accessHelper.data() + lookup.h);
 						};
 
-						double const currLoadFactor {1.0 * (sz + deleted_count) / capacityPolicy.capacity()};
-						if (currLoadFactor > const_values::maxLoadFactor) {
-							rehashTo(capacityPolicy.capacity() << 1);
+						std::size_t const width {std::min(const_values::findManyGroup, keys.size())};
+						for (std::size_t i {0}; i != width; ++i) {
+							active += start(inFlight[i]);
 						}
-						key_type const& key {keyExtractor(mappedValue)};
-						AccessIter elemIter {getElemIter(key)};
-						if (contains(elemIter)) {
+						while (active) {
+							for (std::size_t i {0}; i != width; ++i) {
+								Lookup &lookup {inFlight[i]};
+								if (lookup.idx == done) {
+									continue;
+								}
+								Element<iterator> const& elem {accessHelper[lookup.h]};
+								if (lookup.atNode) {
+									if (equal(keyExtractor(*elem.value()), keys[lookup.idx])) {
+										finish(lookup, elem.value());
+									}
+									else {
+										advance(lookup);
+									}
+								}
+								else if (elem.is_free()) {
+									finish(lookup, data.cend());
+								}
+								else if (elem.has_value()) {
+									__builtin_prefetch(std::addressof(*elem.value()));
+									lookup.atNode = true;
+								}
+								else {
+									advance(lookup);
+								}
+							}
+						}
+					}
+
+					template <typename K>
+					requires is_lookup_key_v<K>
+					iterator find(K const &key) {
+						return find(key, hasher(key));
+					}
+
+					template <typename K>
+					requires is_lookup_key_v<K>
+					const_iterator find(K const &key) const {
+						return find(key, hasher(key));
+					}
+
+					template <typename K>
+					requires is_lookup_key_v<K>
+					iterator find(K const &key, std::size_t hash) {
+						AccessIter elemIter {getElemIter(key, hash)};
+						return contains(elemIter) ? elemIter->value() : data.end();
+					}
+
+					template <typename K>
+					requires is_lookup_key_v<K>
+					const_iterator find(K const &key, std::size_t hash) const {
+						AccessCIter elemIter {getElemIter(key, hash)};
+						return contains(elemIter) ? elemIter->value() : data.end();
+					}
+
+					void reserve(std::size_t count) {
+						if (capacityFor(count + deleted_count) > capacityPolicy.capacity()) {
+							rehashTo(std::max(capacityFor(count), capacityPolicy.capacity()));
+						}
+					}
+
+					void reserveNodes(std::size_t count) {
+						//same layout std::list nodes have — two links and a value
+						struct NodeLayout {
+							void* prev;
+							void* next;
+							alignas(T) std::byte value[sizeof(T)];
+						};
+						std::size_t const spare {deadNodes.size()};
+						if (count > sz + spare) {
+							pmr::reserve(memResourcePtr, sizeof(NodeLayout), alignof(NodeLayout), count - sz - spare);
+						}
+					}
+
+					/**
+					 * Parallel flavour of insertBulk(): keys are hashed and radix-partitioned by the hash on all
+					 * the threads, then each partition is deduplicated on its own, in parallel as well.
+					 * What is left for the calling thread is making the nodes, as the node resource is not
+					 * synchronized; they are placed into the index by placeByRegions() on threads again,
+					 * with the hashes known and no keys to compare.
+					 * Input order and the first of equal keys winning are the same as with insertBulk().
+					 * */
+					template <std::random_access_iterator InputIt>
+					void insertParallel(InputIt first, std::size_t count, std::size_t threads) {
+						std::size_t const chunks {parallel::chunksFor(threads, count, const_values::parallelMinChunk)};
+						int const partitionBits {parallel::partBitsFor(chunks)};
+						std::size_t const partitions {std::size_t{1} << partitionBits};
+						parallel::HashPartitions partitioned {parallel::partitionByHash(chunks, count, partitionBits, [this, &first](std::size_t i) {
+							return hasher(keyOfInput(first[i]));
+						})};
+						std::vector<std::size_t> const &hashes {partitioned.hashes}, &partitionStart {partitioned.start};
+						std::vector<std::size_t> &order {partitioned.order};
+
+						//not std::vector<bool>, the flags are written from several threads
+						std::vector<unsigned char> keep (count, 0);
+						Access const& self {*this};
+						parallel::forChunks(std::min(chunks, partitions), partitions, [&](std::size_t, std::size_t begin, std::size_t end) {
+							std::vector<std::size_t> local;
+							for (std::size_t partition {begin}; partition != end; ++partition) {
+								std::size_t const size {partitionStart[partition + 1] - partitionStart[partition]};
+								std::size_t const localBits {static_cast<std::size_t>(std::bit_width(std::bit_ceil(size * 2 + 1)) - 1)};
+								std::size_t const localMask {(std::size_t{1} << localBits) - 1};
+								local.assign(localMask + 1, count);
+								for (std::size_t pos {partitionStart[partition]}; pos != partitionStart[partition + 1]; ++pos) {
+									std::size_t const i {order[pos]};
+									auto const& key {keyOfInput(first[i])};
+									if (self.sz != 0 && self.contains(self.getElemIter(key, hashes[i]))) {
+										continue;
+									}
+									//the bits right after the partition ones
+									std::size_t h {static_cast<std::size_t>((parallel::mix(hashes[i]) << partitionBits) >> (64 - std::max<std::size_t>(localBits, 1))) & localMask};
+									bool duplicate {false};
+									for (; local[h] != count; h = (h + 1) & localMask) {
+										if (hashes[local[h]] == hashes[i] && equal(keyOfInput(first[local[h]]), key)) {
+											duplicate = true;
+											break;
+										}
+									}
+									if (!duplicate) {
+										local[h] = i;
+										keep[i] = 1;
+									}
+								}
+							}
+						});
+						order = {};
+
+						//the index is sized for the keys taken, the duplicates are gone already
+						std::size_t const kept {static_cast<std::size_t>(std::count(keep.begin(), keep.end(), 1))};
+						reserve(sz + kept);
+						Data staged (pmr::allocator_type<T>{memResourcePtr});
+						std::vector<iterator> nodes (count);
+						for (std::size_t i {0}; i != count; ++i) {
+							if (keep[i] != 0) {
+								staged.emplace_back(first[i]);
+								nodes[i] = std::prev(staged.end());
+							}
+						}
+						try {
+							placeByRegions(accessHelper, chunks, count,
+								[&keep](std::size_t i) { return keep[i] != 0; },
+								[&hashes](std::size_t i) { return hashes[i]; },
+								[&nodes](std::size_t i) { return nodes[i]; },
+								"Unable to emplace while bulk inserting");
+						}
+						catch (...) {
+							//staged nodes are not in data, so the index rebuilt from data has none of them
+							reindex();
+							throw;
+						}
+						sz += kept;
+						data.splice(data.end(), staged);
+					}
+
+					//the key of an input element, that is not necessarily T, ie std::pair<Key, Value> for a map
+					template <typename Value>
+					static decltype(auto) keyOfInput(Value const& value) {
+						if constexpr (requirements::is_map_v<type>) {
+							return (value.first);
+						}
+						else {
+							return (value);
+						}
+					}
+
+					//smallest capacity to keep count elements within maxLoadFactor
+					static std::size_t capacityFor(std::size_t count) {
+						std::size_t cap {const_values::initial_capacity};
+						while (count > cap * const_values::maxLoadFactor) {
+							cap <<= 1;
+						}
+						return cap;
+					}
+
+					/**
+					 * All the values are put into nodes first, keeping input order, then the index is resized once
+					 * for the final size, then keys are hashed and placed, going over the index region by region,
+					 * instead of jumping all over it. The first of equal keys wins, as with the repetitive insert.
+					 * Unchecked assumes keys are unique and new, so no keys are compared, each goes to the first free slot.
+					 * */
+					template <bool Unchecked = false, std::input_iterator InputIt, std::sentinel_for<InputIt> Sentinel>
+					void insertBulk(InputIt first, Sentinel last) {
+						if constexpr (multiKeys) {
+							//nothing to deduplicate, but each value goes next to its equal keys
+							for (; first != last; ++first) {
+								emplace(*first);
+							}
+							return;
+						}
+						Data staged (pmr::allocator_type<T>{memResourcePtr});
+						for (; first != last; ++first) {
+							staged.emplace_back(*first);
+						}
+						if (staged.empty()) {
+							return;
+						}
+						std::size_t const capacityBefore {capacityPolicy.capacity()};
+						reserve(sz + staged.size());
+
+						struct Pending {
+							std::size_t hash;
+							typename Data::iterator node;
+						};
+						std::vector<Pending> pending;
+						pending.reserve(staged.size());
+						for (typename Data::iterator node {staged.begin()}; node != staged.end(); ++node) {
+							pending.push_back({hasher(keyExtractor(*node)), node});
+						}
+
+						//one pass of counting sort by the index region, stable, so the first of equal keys goes first
+						std::size_t const
+							mask {capacityPolicy.mask()},
+							regionShift {static_cast<std::size_t>(std::max(0, static_cast<int>(std::bit_width(mask)) - const_values::bulkRegionBits))},
+							regions {(mask >> regionShift) + 1};
+						std::vector<std::size_t> offsets (regions + 1, 0);
+						for (Pending const& item : pending) {
+							++offsets[((item.hash & mask) >> regionShift) + 1];
+						}
+						for (std::size_t i {1}; i != offsets.size(); ++i) {
+							offsets[i] += offsets[i - 1];
+						}
+						std::vector<Pending> ordered (pending.size());
+						for (Pending const& item : pending) {
+							ordered[offsets[(item.hash & mask) >> regionShift]++] = item;
+						}
+						pending = std::vector<Pending>{};
+
+						std::vector<std::size_t> placed;
+						placed.reserve(ordered.size());
+						try {
+							for (Pending const& item : ordered) {
+								if constexpr (Unchecked) {
+									assert(!contains(getElemIter(keyExtractor(*item.node), item.hash)) && "unchecked insert gets a duplicate key");
+									std::size_t const idx {freeSlot(accessHelper, mask, item.hash)};
+									if (idx == accessHelper.size()) {
+										throw std::runtime_error("Unable to emplace while bulk inserting");
+									}
+									accessHelper[idx].emplace(item.node);
+									placed.push_back(idx);
+									continue;
+								}
+								AccessIter elemIter {getElemIter(keyExtractor(*item.node), item.hash)};
+								if (contains(elemIter)) {
+									staged.erase(item.node);
+								}
+								else if (elemIter != accessHelper.end()) {
+									elemIter->emplace(item.node);
+									placed.push_back(static_cast<std::size_t>(elemIter - accessHelper.begin()));
+								}
+								else {
+									throw std::runtime_error("Unable to emplace while bulk inserting");
+								}
+							}
+						}
+						catch (...) {
+							for (std::size_t idx : placed) {
+								accessHelper[idx] = Element<iterator>{};
+							}
+							throw;
+						}
+						sz += placed.size();
+						data.splice(data.end(), staged);
+						if constexpr (!Unchecked) {
+							//the index got room for the duplicates as well, that is given back if they were many
+							if (std::size_t const fit {std::max(capacityBefore, capacityFor(sz))}; fit < capacityPolicy.capacity()) {
+								rehashTo(fit);
+							}
+						}
+					}
+
+					std::pair<iterator, bool> insert(T mappedValue){
+						std::size_t const hash {hasher(keyExtractor(mappedValue))};
+						return insert(std::move(mappedValue), hash);
+					}
+
+					iterator insertUnchecked(T mappedValue){
+						std::size_t const hash {hasher(keyExtractor(mappedValue))};
+						assert(!contains(keyExtractor(mappedValue), hash) && "unchecked insert gets a duplicate key");
+						allocateIndex();
+						double const currLoadFactor {1.0 * (sz + deleted_count) / capacityPolicy.capacity()};
+						if (currLoadFactor > const_values::maxLoadFactor) {
+							rehashTo(capacityPolicy.capacity() << 1);
+						}
+						std::size_t const idx {freeSlot(accessHelper, capacityPolicy.mask(), hash)};
+						if (idx == accessHelper.size()) {
+							throw std::runtime_error("Unable to emplace, consider reducing const_values::maxLoadFactor");
+						}
+						iterator node {placeNode(std::move(mappedValue))};
+						accessHelper[idx].emplace(node);
+						++sz;
+						return node;
+					}
+
+					std::pair<iterator, bool> insert(T mappedValue, std::size_t hash){
+						key_type const& key {keyExtractor(mappedValue)};
+						auto [elemIter, found] {probeForInsert(key, hash)};
+						if (found && !multiKeys) {
+							return {elemIter->value(), false};
+						}
+						return {linkNode(elemIter, found, placeNode(std::move(mappedValue))), true};
+					}
+
+					/**
+					 * Value is constructed right in the list node, the key is taken from there.
+					 * If it is a duplicate, the node is dropped, as it is done by std::unordered_map.
+					 * Map's (key, value) goes through tryEmplace(), so nothing is constructed for a duplicate.
+					 * */
+					template <typename... Args>
+					std::pair<iterator, bool> emplace(Args&&... args){
+						if constexpr (requirements::is_map_v<type> && !multiKeys && sizeof...(Args) == 2) {
+							if constexpr (std::same_as<std::remove_cvref_t<std::tuple_element_t<0, std::tuple<Args...>>>, std::remove_cv_t<key_type>>) {
+								return tryEmplace(std::forward<Args>(args)...);
+							}
+						}
+						iterator node {placeNode(std::forward<Args>(args)...)};
+						std::pair<AccessIter, bool> probed;
+						try {
+							key_type const& key {keyExtractor(*node)};
+							probed = probeForInsert(key, hasher(key));
+						}
+						catch (...) {
+							dropNode(node);
+							throw;
+						}
+						if (probed.second && !multiKeys) {
+							dropNode(node);
+							return {probed.first->value(), false};
+						}
+						return {linkNode(probed.first, probed.second, node), true};
+					}
+
+					//mapped value is constructed from args only if the key is not there
+					template <typename K, typename... Args>
+					std::pair<iterator, bool> tryEmplace(K&& key, Args&&... args)
+					requires requirements::is_map_v<type> && (!multiKeys)
+					{
+						std::size_t const hash {hasher(key)};
+						return tryEmplaceHashed(hash, std::forward<K>(key), std::forward<Args>(args)...);
+					}
+
+					template <typename K, typename... Args>
+					std::pair<iterator, bool> tryEmplaceHashed(std::size_t hash, K&& key, Args&&... args)
+					requires requirements::is_map_v<type> && (!multiKeys)
+					{
+						auto [elemIter, found] {probeForInsert(key, hash)};
+						if (found) {
 							return {elemIter->value(), false};
 						}
-						else if (emplaceable(elemIter)) {
-							elemIter->emplace(place_to_data(std::move(mappedValue)));
-							return {elemIter->value(), true};
+						elemIter->emplace(placeNode(
+							std::piecewise_construct,
+							std::forward_as_tuple(std::forward<K>(key)),
+							std::forward_as_tuple(std::forward<Args>(args)...)
+						));
+						++sz;
+						return {elemIter->value(), true};
+					}
+
+					bool emplaceable(AccessCIter iter) const {
+						return iter != accessHelper.cend() && iter->is_free();
+					}
+
+					/**
+					 * Slot holding the key and true, or a free slot for it and false.
+					 * The index is grown beforehand if the load is too high or there is no free slot on the way.
+					 * */
+					template <typename K>
+					requires is_lookup_key_v<K>
+					std::pair<AccessIter, bool> probeForInsert(K const &key, std::size_t hash){
+						allocateIndex();
+						double const currLoadFactor {1.0 * (sz + deleted_count) / capacityPolicy.capacity()};
+						if (currLoadFactor > const_values::maxLoadFactor) {
+							rehashTo(capacityPolicy.capacity() << 1);
+						}
+						AccessIter elemIter {getElemIter(key, hash)};
+						if (contains(elemIter)) {
+							return {elemIter, true};
+						}
+						int attempts {const_values::maxEmplaceAttempts};
+						while (attempts-- && !emplaceable(elemIter)){
+							rehashTo(capacityPolicy.capacity() << 1);
+							elemIter = getElemIter(key, hash);
+						}
+						if (!emplaceable(elemIter)) {
+							throw std::runtime_error("Unable to emplace after rehash, consider reducing const_values::maxLoadFactor");
+						}
+						return {elemIter, false};
+					}
+
+					//constructs a value in a node at the end of data, the node is not indexed and not counted yet
+					template <typename... Args>
+					iterator placeNode(Args&&... args){
+						if constexpr (recyclableNodes) {
+							if (!deadNodes.empty()) {
+								//nothing to destroy in a dead node, it is just overwritten and relinked
+								typename Data::iterator node {deadNodes.begin()};
+								std::construct_at(std::addressof(*node), std::forward<Args>(args)...);
+								data.splice(data.end(), deadNodes, node);
+								return node;
+							}
+						}
+						//pmr list constructs the value in the node, passing the allocator down if T is allocator aware
+						data.emplace_back(std::forward<Args>(args)...);
+						return std::prev(data.end());
+					}
+
+					/**
+					 * Indexes a node that is in data already. If the key is there (found), that is a multi table,
+					 * and the node is moved to the end of its equal keys' group, keeping insertion order within it.
+					 * */
+					iterator linkNode(AccessIter elemIter, bool found, iterator node){
+						if constexpr (multiKeys) {
+							if (found) {
+								key_type const& key {keyExtractor(*node)};
+								iterator groupEnd {std::next(elemIter->value())};
+								while (groupEnd != data.end() && groupEnd != node && equal(keyExtractor(*groupEnd), key)) {
+									++groupEnd;
+								}
+								data.splice(groupEnd, data, node);
+								++sz;
+								return node;
+							}
+						}
+						elemIter->emplace(node);
+						++sz;
+						return node;
+					}
+
+					//takes a node, that is about to leave data, out of the index
+					void unindex(const_iterator node, std::size_t hash){
+						key_type const& key {keyExtractor(*node)};
+						unindexAt(getElemIter(key, hash), node, key);
+					}
+
+					//elemIter is the slot of the key, that is passed aside, as the node's value may be moved from already
+					void unindexAt(AccessIter elemIter, const_iterator node, key_type const& key){
+						--sz;
+						if constexpr (multiKeys) {
+							if (elemIter->value() != node) {
+								return;
+							}
+							iterator next {std::next(elemIter->value())};
+							if (next != data.end() && equal(keyExtractor(*next), key)) {
+								elemIter->emplace(next);
+								return;
+							}
+						}
+						elemIter->reset();
+						++deleted_count;
+					}
+
+					void unindex(const_iterator node){
+						unindex(node, hasher(keyExtractor(*node)));
+					}
+
+					//node goes aside, its value is destroyed at the next rehash
+					void unlinkNode(const_iterator node){
+						unindex(node);
+						deadNodes.splice(deadNodes.end(), data, node);
+					}
+
+					void dropNode(const_iterator node){
+						if constexpr (recyclableNodes) {
+							deadNodes.splice(deadNodes.end(), data, node);
 						}
 						else {
-							int attempts {const_values::maxEmplaceAttempts};
-							while (attempts-- && !emplaceable(elemIter)){
-								rehashTo(capacityPolicy.capacity() << 1);
-								elemIter = getElemIter(key);
+							data.erase(node);
+						}
+					}
+
+					node_type extract(const_iterator pos){
+						unindex(pos);
+						node_type handle {data.get_allocator()};
+						handle.node->splice(handle.node->end(), data, pos);
+						tryShrink();
+						return handle;
+					}
+
+					insert_return_type insertNode(node_type &&handle){
+						if (handle.empty()) {
+							return {data.end(), false, {}};
+						}
+						Data &node {*handle.node};
+						key_type const& key {keyExtractor(node.front())};
+						auto [elemIter, found] {probeForInsert(key, hasher(key))};
+						if (found && !multiKeys) {
+							return {elemIter->value(), false, std::move(handle)};
+						}
+						if (node.get_allocator() == data.get_allocator()) {
+							data.splice(data.end(), node);
+						}
+						else {
+							placeNode(std::move(node.front()));
+						}
+						handle.node.reset();
+						return {linkNode(elemIter, found, std::prev(data.end())), true, {}};
+					}
+
+					/**
+					 * Takes over the elements of other, whose keys are not here, duplicates stay in other,
+					 * unless that is a multi table, then it takes everything.
+					 * Nodes are relinked if both tables use the same resource, otherwise values are moved.
+					 * */
+					void merge(Access &other){
+						if (&other == this) {
+							return;
+						}
+						reserve(sz + other.sz);
+						bool const relink {data.get_allocator() == other.data.get_allocator()};
+						for (typename Data::iterator node {other.data.begin()}; node != other.data.end();) {
+							typename Data::iterator const curr {node++};
+							key_type const& key {keyExtractor(*curr)};
+							std::size_t const hash {hasher(key)};
+							auto [elemIter, found] {probeForInsert(key, hash)};
+							if (found && !multiKeys) {
+								continue;
+							}
+							std::size_t const otherHash {std::is_empty_v<Hasher> ? hash : other.hasher(key)};
+							if (relink) {
+								//nothing throws past this point
+								other.unindex(curr, otherHash);
+								data.splice(data.end(), other.data, curr);
+								linkNode(elemIter, found, std::prev(data.end()));
+								continue;
 							}
-							if (!emplaceable(elemIter)) {
-								throw std::runtime_error("Unable to emplace after rehash, consider reducing const_values::maxLoadFactor");
+							//the new node is made first, so if that throws, other still has the element indexed
+							AccessIter const otherSlot {other.getElemIter(key, otherHash)};
+							iterator const placed {placeNode(std::move_if_noexcept(*curr))};
+							other.unindexAt(otherSlot, curr, keyExtractor(*placed));
+							other.dropNode(curr);
+							linkNode(elemIter, found, placed);
+						}
+						other.tryShrink();
+					}
+
+					/**
+					 * Takes over all the elements of others, whose keys are known to be in none of the tables
+					 * but one, ie partials aggregated per hash partition. No keys are compared, the nodes
+					 * are placed into the index by placeByRegions() on threads. Nodes of the tables that share
+					 * the resource are relinked, the values of the rest are moved into new nodes on the calling
+					 * thread. Others are left empty; if anything throws, every table is left as it was.
+					 * */
+					void mergeUnchecked(std::vector<Access*> const& others, std::size_t threads) {
+						std::size_t count {0};
+						for (Access const* other : others) {
+							count += other->sz;
+						}
+						if (count == 0) {
+							return;
+						}
+						reserve(sz + count);
+
+						//relinked nodes stay in their lists till the index is built, list iterators survive splice
+						Data staged (pmr::allocator_type<T>{memResourcePtr});
+						std::vector<iterator> nodes;
+						std::vector<typename Data::iterator> movedFrom;
+						nodes.reserve(count);
+						auto restore = [&staged, &movedFrom]() noexcept {
+							if constexpr (std::is_nothrow_move_constructible_v<T>) {
+								typename std::vector<typename Data::iterator>::const_iterator from {movedFrom.cbegin()};
+								for (T &moved : staged) {
+									std::destroy_at(std::addressof(**from));
+									std::construct_at(std::addressof(**from++), std::move(moved));
+								}
+							}
+							//otherwise they were copied, the sources are intact
+						};
+						try {
+							for (Access *other : others) {
+								bool const relink {data.get_allocator() == other->data.get_allocator()};
+								for (typename Data::iterator node {other->data.begin()}; node != other->data.end(); ++node) {
+									if (relink) {
+										nodes.push_back(node);
+										continue;
+									}
+									movedFrom.push_back(node);
+									staged.emplace_back(std::move_if_noexcept(*node));
+									nodes.push_back(std::prev(staged.end()));
+								}
 							}
-							elemIter->emplace(place_to_data(std::move(mappedValue)));
-							return {elemIter->value(), true};
 						}
+						catch (...) {
+							restore();
+							throw;
+						}
+						try {
+							placeByRegions(accessHelper, parallel::chunksFor(threads, count, const_values::parallelMinChunk), count,
+								[](std::size_t) { return true; },
+								[this, &nodes](std::size_t i) { return hasher(keyExtractor(*nodes[i])); },
+								[&nodes](std::size_t i) { return nodes[i]; },
+								"Unable to emplace while merging");
+						}
+						catch (...) {
+							//none of the nodes are in data yet, so the index rebuilt from data has none of them
+							reindex();
+							restore();
+							throw;
+						}
+
+						sz += count;
+						for (Access *other : others) {
+							if (data.get_allocator() == other->data.get_allocator()) {
+								data.splice(data.end(), other->data);
+							}
+							other->clear();
+						}
+						data.splice(data.end(), staged);
 					}
 #if 0
 					void erase(key_type const &key) {
@@ -452,82 +1770,562 @@ namespace containers {
 						tryShrink();
 					}
 #else
-					void erase(key_type const &key) {
-						AccessIter elemIter {getElemIter(key)};
+					template <typename K>
+					requires is_lookup_key_v<K>
+					void erase(K const &key) {
+						erase(key, hasher(key));
+					}
+
+					template <typename K>
+					requires is_lookup_key_v<K>
+					void erase(K const &key, std::size_t hash) {
+						AccessIter elemIter {getElemIter(key, hash)};
 						if (!contains(elemIter)) {
 							return;
 						}
-						deadNodes.splice(deadNodes.end(), data, elemIter->value());
+						unlink(elemIter);
+						tryShrink();
+					}
+#endif
+
+					void erase(const_iterator cIter){
+						if (cIter == data.cend()) {
+							return;
+						}
+						unlinkNode(cIter);
+						tryShrink();
+					}
+
+					//all the nodes of the slot's key go aside, values are destroyed at the next rehash
+					void unlink(AccessIter elemIter){
+						iterator const first {elemIter->value()};
+						iterator last {std::next(first)};
+						std::size_t count {1};
+						if constexpr (multiKeys) {
+							for (; last != data.end() && equal(keyExtractor(*last), keyExtractor(*first)); ++last) {
+								++count;
+							}
+						}
+						deadNodes.splice(deadNodes.end(), data, first, last);
 						// data.erase(elemIter->value());
 						elemIter->reset();
-						--sz;
+						sz -= count;
 						++deleted_count;
+					}
+
+					/**
+					 * Bulk erases only mark the slots, and then there is at most one rehash —
+					 * a shrink if the load allows, or a rebuild at the same capacity if tombstones outnumber elements.
+					 * */
+					void settleAfterErase(){
+						if (deferredMaintenance) {
+							return;
+						}
+						std::size_t const currCapacity {capacityPolicy.capacity()};
 						tryShrink();
+						if (currCapacity == capacityPolicy.capacity() && deleted_count > sz) {
+							rehashTo(currCapacity);
+						}
 					}
-#endif
 
-					void erase(const_iterator cIter){
-						key_type const& key {keyExtractor(*cIter)};
-						erase(key);
+					template <typename Pred>
+					std::size_t eraseIf(Pred &pred){
+						std::size_t const before {sz};
+						for (typename Data::iterator node {data.begin()}; node != data.end();) {
+							typename Data::iterator const curr {node++};
+							if (pred(std::as_const(*curr))) {
+								unlinkNode(curr);
+							}
+						}
+						settleAfterErase();
+						return before - sz;
+					}
+
+					iterator erase(const_iterator first, const_iterator last){
+						while (first != last) {
+							unlinkNode(first++);
+						}
+						settleAfterErase();
+						//the way to get a mutable iterator out of a const one
+						return data.erase(last, last);
+					}
+
+					std::size_t eraseMany(std::span<key_type const> keys){
+						std::size_t const before {sz};
+						for (key_type const& key : keys) {
+							AccessIter elemIter {getElemIter(key)};
+							if (contains(elemIter)) {
+								unlink(elemIter);
+							}
+						}
+						settleAfterErase();
+						return before - sz;
 					}
 
 
 					void tryShrink() {
+						if (!deferredMaintenance) {
+							shrink();
+						}
+					}
+
+					//smallest capacity, halving the current one, with the load kept within loadLimit
+					std::size_t shrunkCapacity(double loadLimit) const {
 						std::size_t targetCapacity {capacityPolicy.capacity()};
-						while (targetCapacity > const_values::initial_capacity && 1.0 * sz / (targetCapacity >> 1) <= const_values::maxLoadFactor) 
+						while (targetCapacity > const_values::initial_capacity && 1.0 * sz / (targetCapacity >> 1) <= loadLimit) 
 						{
 							targetCapacity >>= 1;
 						}
+						return targetCapacity;
+					}
+
+					void shrink() {
+						std::size_t const targetCapacity {shrunkCapacity(const_values::maxLoadFactor)};
 						if (targetCapacity < capacityPolicy.capacity()) {
+							std::size_t const shrunkFrom {capacityPolicy.capacity()};
 							rehashTo(targetCapacity);
+							if (autoTrimFrom != 0 && shrunkFrom >= autoTrimFrom) {
+								releaseUnused();
+							}
+						}
+					}
+
+					/**
+					 * Capacity the index is to be rebuilt at, 0 if it is fine as is.
+					 * Growth once the live elements are over the watermark, down to half of it after the rebuild;
+					 * shrink to half of the watermark, so the next growth is not right away;
+					 * a rebuild at the same capacity if tombstones push the load over the watermark or outnumber elements.
+					 * */
+					std::size_t maintenanceCapacity(double watermark) const {
+						std::size_t const currCapacity {capacityPolicy.capacity()};
+						if (sz > currCapacity * watermark) {
+							return currCapacity << 1;
 						}
+						std::size_t const targetCapacity {shrunkCapacity(watermark / 2)};
+						if (targetCapacity < currCapacity || sz + deleted_count > currCapacity * watermark || deleted_count > sz) {
+							return targetCapacity;
+						}
+						return 0;
+					}
+
+					bool needsMaintenance(double watermark) const {
+						//parked nodes of the types that are not recycled are just kept for the next rehash
+						return maintenanceCapacity(watermark) != 0 || (!recyclableNodes && deadNodes.size() > sz);
+					}
+
+					bool maintain(double watermark) {
+						if (std::size_t const targetCapacity {maintenanceCapacity(watermark)}; targetCapacity != 0) {
+							rehashTo(targetCapacity);
+							return true;
+						}
+						if (!recyclableNodes && deadNodes.size() > sz) {
+							deadNodes.clear();
+							return true;
+						}
+						return false;
+					}
+
+					std::size_t releaseUnused() {
+						deadNodes.clear();
+						accessHelper.shrink_to_fit();
+						return pmr::trim(memResourcePtr);
 					}
 
 					void rehashTo(std::size_t newCapacity) {
+						if (parallelRehashFrom != 0 && sz >= parallelRehashFrom && rehashThreads > 1) {
+							rehashParallel(newCapacity);
+							return;
+						}
 
 						capacityPolicy.setCapacity(newCapacity);
 						std::size_t const newMask {capacityPolicy.mask()};
-						AccessHelper newAccessHelper(newCapacity);
+						AccessHelper newAccessHelper(newCapacity, accessHelper.get_allocator());
 
 						for (Element<iterator> &entry : accessHelper) {
-							if (entry.has_value()) {
-								std::size_t h {hasher(keyExtractor(*(entry.value()))) & newMask};
-								std::size_t const step {h | 1};
-								bool entryUpdated {false};
-
-								for (std::size_t i {0}; i != newCapacity; ++i) {
-									if (newAccessHelper[h].is_free()) {
-										newAccessHelper[h] = entry;
-										entryUpdated = true;
-										break;
-									}
-									h = (h + step) & newMask;
+							if (entry.has_value() && !emplaceFree(newAccessHelper, newMask, entry.value())) {
+								throw std::runtime_error("Failed to update element while rehashing");
+							}
+						}
+						std::swap(accessHelper, newAccessHelper);
+						deleted_count = 0;
+						deadNodes.clear();
+					}
+
+					/**
+					 * Elements at [0, count), the ones has(idx) is true for, are put into target on threads.
+					 * Split in chunks, they are hashed by hashOf(idx) and counted by the region of target they go to;
+					 * then they are put into their home slots, a region per thread at a time, so no slot is written
+					 * by two threads. The ones that find the home slot taken, a minority with the load kept low,
+					 * are placed along their probe sequences afterwards, on the calling thread. A slot is never freed,
+					 * so that keeps every probe sequence unbroken, the slots target has taken already included.
+					 * */
+					template <typename Has, typename HashOf, typename NodeOf>
+					static void placeByRegions(AccessHelper &target, std::size_t chunks, std::size_t count,
+											   Has const& has, HashOf const& hashOf, NodeOf const& nodeOf, char const* failure) {
+						std::size_t const
+							mask {target.size() - 1},
+							regionBits {std::min(
+								static_cast<std::size_t>(std::bit_width(std::bit_ceil(chunks * const_values::parallelPartitionsPerThread)) - 1),
+								static_cast<std::size_t>(std::bit_width(mask)))},
+							regionShift {static_cast<std::size_t>(std::bit_width(mask)) - regionBits},
+							regions {std::size_t{1} << regionBits};
+
+						struct Moved {
+							std::size_t hash;
+							iterator node;
+						};
+						std::vector<std::size_t> hashes (count);
+						std::vector<std::vector<std::size_t>> offsets (chunks, std::vector<std::size_t>(regions, 0));
+						parallel::forChunks(chunks, count, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+							for (std::size_t idx {begin}; idx != end; ++idx) {
+								if (has(idx)) {
+									hashes[idx] = hashOf(idx);
+									++offsets[chunk][(hashes[idx] & mask) >> regionShift];
 								}
-								if (!entryUpdated) {
-									throw std::runtime_error("Failed to update element while rehashing");
+							}
+						});
+						std::vector<std::size_t> regionStart (regions + 1, 0);
+						for (std::size_t region {0}, running {0}; region != regions; ++region) {
+							regionStart[region] = running;
+							for (std::vector<std::size_t> &chunkOffsets : offsets) {
+								running += std::exchange(chunkOffsets[region], running);
+							}
+							regionStart[region + 1] = running;
+						}
+						std::vector<Moved> ordered (regionStart.back());
+						parallel::forChunks(chunks, count, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+							for (std::size_t idx {begin}; idx != end; ++idx) {
+								if (has(idx)) {
+									ordered[offsets[chunk][(hashes[idx] & mask) >> regionShift]++] = {hashes[idx], nodeOf(idx)};
 								}
 							}
+						});
+						hashes = {};
+						offsets = {};
+
+						std::vector<std::vector<Moved>> deferred (std::min(chunks, regions));
+						parallel::forChunks(deferred.size(), regions, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+							for (std::size_t pos {regionStart[begin]}; pos != regionStart[end]; ++pos) {
+								Element<iterator> &home {target[ordered[pos].hash & mask]};
+								if (home.is_free()) {
+									home.emplace(ordered[pos].node);
+								}
+								else {
+									deferred[chunk].push_back(ordered[pos]);
+								}
+							}
+						});
+						for (std::vector<Moved> const& moved : deferred) {
+							for (Moved const& item : moved) {
+								std::size_t const idx {freeSlot(target, mask, item.hash)};
+								if (idx == target.size()) {
+									throw std::runtime_error(failure);
+								}
+								target[idx].emplace(item.node);
+							}
 						}
+					}
+
+					//same result as rehashTo(), the new index is built by placeByRegions() on rehashThreads
+					void rehashParallel(std::size_t newCapacity) {
+						//the table is left as is, if anything throws
+						CapacityPolicy newPolicy {capacityPolicy};
+						newPolicy.setCapacity(newCapacity);
+						AccessHelper newAccessHelper(newPolicy.capacity(), accessHelper.get_allocator());
+
+						std::size_t const oldCapacity {accessHelper.size()};
+						placeByRegions(newAccessHelper, parallel::chunksFor(rehashThreads, oldCapacity, const_values::parallelMinChunk), oldCapacity,
+							[this](std::size_t idx) { return accessHelper[idx].has_value(); },
+							[this](std::size_t idx) { return hasher(keyExtractor(*accessHelper[idx].value())); },
+							[this](std::size_t idx) { return accessHelper[idx].value(); },
+							"Failed to update element while rehashing");
+						capacityPolicy = newPolicy;
 						std::swap(accessHelper, newAccessHelper);
 						deleted_count = 0;
 						deadNodes.clear();
 					}
 
+					void clear() {
+						if constexpr (recyclableNodes) {
+							//O(1), nodes are parked to be reused by the next inserts
+							deadNodes.splice(deadNodes.end(), data);
+						}
+						else {
+							data.clear();
+							deadNodes.clear();
+						}
+						accessHelper.assign(capacityPolicy.capacity(), {});
+						sz = 0;
+						deleted_count = 0;
+					}
+
+					//moved-from state, nodes should be taken away already; the index is freed, not allocated anew
+					void reset() noexcept {
+						capacityPolicy.clear();
+						AccessHelper {accessHelper.get_allocator()}.swap(accessHelper);
+						sz = 0;
+						deleted_count = 0;
+					}
+
+					//the index a moved-from table left without, before the first insert
+					void allocateIndex() {
+						if (accessHelper.empty()) {
+							capacityPolicy = CapacityPolicy {0, sizeof(T)};
+							accessHelper.resize(capacityPolicy.capacity());
+						}
+					}
+
+					//no equality checks, keys are known to be unique, just the first free slot along the probe sequence
+					bool emplaceFree(AccessHelper &target, std::size_t mask, iterator iter) {
+						std::size_t const idx {freeSlot(target, mask, hasher(keyExtractor(*iter)))};
+						if (idx == target.size()) {
+							return false;
+						}
+						target[idx].emplace(iter);
+						return true;
+					}
+
+					//first free slot on the probe sequence of the hash, no keys compared; target.size() if there is none
+					static std::size_t freeSlot(AccessHelper const &target, std::size_t mask, std::size_t hash) {
+						std::size_t h {hash & mask};
+						std::size_t const step {h | 1};
+						for (std::size_t i {0}, cap {mask + 1}; i != cap; ++i) {
+							if (target[h].is_free()) {
+								return h;
+							}
+							h = (h + step) & mask;
+						}
+						return target.size();
+					}
+
+					//rebuilds index from data as is, keeping current capacity, tombstones are gone
+					void reindex() {
+						std::size_t const mask {capacityPolicy.mask()};
+						accessHelper.assign(capacityPolicy.capacity(), {});
+						for (iterator iter {data.begin()}; iter != data.end(); ++iter) {
+							if constexpr (multiKeys) {
+								//only the first of equal keys is indexed
+								if (iter != data.begin() && equal(keyExtractor(*std::prev(iter)), keyExtractor(*iter))) {
+									continue;
+								}
+							}
+							if (!emplaceFree(accessHelper, mask, iter)) {
+								throw std::runtime_error("Failed to update element while reindexing");
+							}
+						}
+						deleted_count = 0;
+					}
+
+					//a single pass over the source list, slots are recomputed for the copied nodes,
+					//no old-to-new node mapping is required, the source's tombstones are not carried over
+					void copyFrom(Access const& other) {
+						for (T const& item : other.data) {
+							data.emplace_back(item);
+						}
+						capacityPolicy = other.capacityPolicy;
+						sz = other.sz;
+						autoTrimFrom = other.autoTrimFrom;
+						deferredMaintenance = other.deferredMaintenance;
+						parallelRehashFrom = other.parallelRehashFrom;
+						rehashThreads = other.rehashThreads;
+						reindex();
+					}
+
+					template <typename Relocate>
+					void compact(Relocate &relocate) {
+						Data fresh (pmr::allocator_type<T>{memResourcePtr});
+						{
+							//no holes of the freed nodes are reused, so with a trimmable pool, as the default one is,
+							//the new nodes are placed one after another in fresh chunks, following iteration order
+							pmr::FreshBlocksScope const freshBlocks {memResourcePtr};
+							try {
+								for (typename Data::iterator iter {data.begin()}; iter != data.end(); ++iter) {
+									fresh.emplace_back(std::move_if_noexcept(*iter));
+								}
+							}
+							catch (...) {
+								if constexpr (std::is_nothrow_move_constructible_v<T>) {
+									//the elements moved so far go back to their nodes, the index still points there
+									typename Data::iterator iter {data.begin()};
+									for (T &moved : fresh) {
+										std::destroy_at(std::addressof(*iter));
+										std::construct_at(std::addressof(*iter++), std::move(moved));
+									}
+								}
+								//otherwise they were copied, the table is intact
+								throw;
+							}
+						}
+						data.swap(fresh);
+						reindex();
+						deadNodes.clear();
+						++epoch;
+						//the table is compacted by now, the old nodes are still there for the addresses to be reported
+						typename Data::iterator oldIter {fresh.begin()};
+						for (T const& item : data) {
+							relocate(std::addressof(std::as_const(*oldIter++)), std::addressof(item));
+						}
+					}
+
 					bool contains(AccessCIter iter) const {
 						return iter != accessHelper.end() && iter->has_value();
 					}
 
-					bool contains(key_type const& key) const {
+					template <typename K>
+					requires is_lookup_key_v<K>
+					bool contains(K const& key) const {
 						AccessCIter iter {getElemIter(key)};
 						return contains(iter);
 					}
 
+					template <typename K>
+					requires is_lookup_key_v<K>
+					bool contains(K const& key, std::size_t hash) const {
+						AccessCIter iter {getElemIter(key, hash)};
+						return contains(iter);
+					}
+
+					template <typename K>
+					requires is_lookup_key_v<K>
+					std::pair<iterator, iterator> equalRange(K const& key) {
+						iterator first {find(key)};
+						iterator last {first};
+						if (last != data.end()) {
+							++last;
+							if constexpr (multiKeys) {
+								while (last != data.end() && equal(keyExtractor(*last), key)) {
+									++last;
+								}
+							}
+						}
+						return {first, last};
+					}
+
+					template <typename K>
+					requires is_lookup_key_v<K>
+					std::pair<const_iterator, const_iterator> equalRange(K const& key) const {
+						const_iterator first {find(key)};
+						const_iterator last {first};
+						if (last != data.cend()) {
+							++last;
+							if constexpr (multiKeys) {
+								while (last != data.cend() && equal(keyExtractor(*last), key)) {
+									++last;
+								}
+							}
+						}
+						return {first, last};
+					}
+
 					std::size_t bytesAllocated() const {
 						return accessHelper.capacity() * sizeof(typename AccessHelper::value_type);
 					}
+
+					//a multi table indexes the first of equal keys, the rest are right after it in the list
+					bool sameGroup(const_iterator node, const_iterator next) const {
+						return next != data.cend() && equal(keyExtractor(*next), keyExtractor(*node));
+					}
+
+					//fn on the elements of the index slots [first, last)
+					template <typename Fn>
+					void visitSlots(std::size_t first, std::size_t last, Fn &fn) const {
+						for (std::size_t idx {first}; idx != last; ++idx) {
+							if (!accessHelper[idx].has_value()) {
+								continue;
+							}
+							iterator node {accessHelper[idx].value()};
+							fn(*node);
+							if constexpr (multiKeys) {
+								for (iterator next {std::next(node)}; sameGroup(node, next); node = next++) {
+									fn(*next);
+								}
+							}
+						}
+					}
 				};
 
 			public:
+				/**
+				 * Part of a table, that is a range of its index slots. Elements are in no particular order,
+				 * equal keys of a multi table come together. Valid until the next insert or erase.
+				 * */
+				class partition_view final {
+				public:
+					class iterator final {
+					public:
+						using iterator_category = std::forward_iterator_tag;
+						using value_type = T;
+						using difference_type = std::ptrdiff_t;
+						using pointer = T const*;
+						using reference = T const&;
+
+						iterator() = default;
+
+						reference operator*() const { return *node; }
+						pointer operator->() const { return std::addressof(*node); }
+
+						iterator& operator++() {
+							if constexpr (multiKeys) {
+								if (const_iterator const next {std::next(node)}; access->sameGroup(node, next)) {
+									node = next;
+									return *this;
+								}
+							}
+							++slot;
+							settle();
+							return *this;
+						}
+
+						iterator operator++(int) {
+							iterator const current {*this};
+							++*this;
+							return current;
+						}
+
+						friend bool operator==(iterator const& lhs, iterator const& rhs) {
+							return lhs.slot == rhs.slot && (lhs.slot == lhs.last || lhs.node == rhs.node);
+						}
+
+					private:
+						friend class partition_view;
+
+						iterator(Access const* access_, std::size_t slot_, std::size_t last_)
+							: access {access_}, slot {slot_}, last {last_}
+						{
+							settle();
+						}
+
+						//to the next occupied slot, or to the end
+						void settle() {
+							while (slot != last && !access->accessHelper[slot].has_value()) {
+								++slot;
+							}
+							if (slot != last) {
+								node = access->accessHelper[slot].value();
+							}
+						}
+
+						Access const* access {nullptr};
+						std::size_t slot {0};
+						std::size_t last {0};
+						const_iterator node {};
+					};
+
+					iterator begin() const { return iterator{access, first, last}; }
+					iterator end() const { return iterator{access, last, last}; }
+
+				private:
+					friend class HashTable;
+
+					partition_view(Access const* access_, std::size_t first_, std::size_t last_)
+						: access {access_}, first {first_}, last {last_}
+					{}
+
+					Access const* access;
+					std::size_t first;
+					std::size_t last;
+				};
+
 
 				virtual ~HashTable() = default;
 
@@ -535,52 +2333,43 @@ namespace containers {
 					// : data(pmr::allocator_type{&pmr::resource})
 					: memResourcePtr (&pmr::aligned_resource<T>)
 					, data(pmr::allocator_type<T>{memResourcePtr})
-					, access(data, memResourcePtr)
+					, access(data, memResourcePtr, std::pmr::get_default_resource())
 				{}
 
 				HashTable(std::size_t initialCapacity)
 					// : data(pmr::allocator_type{&pmr::resource})
 					: memResourcePtr (&pmr::aligned_resource<T>)
 					, data(pmr::allocator_type<T>{memResourcePtr})
-					, access(data, initialCapacity, memResourcePtr)
+					, access(data, initialCapacity, memResourcePtr, std::pmr::get_default_resource())
+				{}
+
+				template <std::input_iterator InputIt, std::sentinel_for<InputIt> Sentinel>
+				requires std::constructible_from<T, std::iter_reference_t<InputIt>>
+				HashTable(InputIt first, Sentinel last, std::size_t initialCapacity = 0)
+					: HashTable(initialCapacity)
+				{
+					insert(std::move(first), std::move(last));
+				}
+
+				/**
+				 * nodeResource is for the list nodes, indexResource is for the index array.
+				 * Both are not owned and should outlive the table.
+				 * */
+				HashTable(std::size_t initialCapacity,
+						  std::pmr::memory_resource* nodeResource,
+						  std::pmr::memory_resource* indexResource = std::pmr::get_default_resource())
+					: memResourcePtr (nodeResource)
+					, data(pmr::allocator_type<T>{memResourcePtr})
+					, access(data, initialCapacity, memResourcePtr, indexResource)
 				{}
 
 				HashTable(HashTable const& other)
 				    // : data(pmr::allocator_type{&pmr::resource})
 					: memResourcePtr (other.memResourcePtr)
 					, data(pmr::allocator_type<T>{memResourcePtr})
-				    , access(data, other.access.capacityPolicy.capacity(), memResourcePtr)
+				    , access(data, other.access.capacityPolicy.capacity(), memResourcePtr, other.indexResource())
 				{
-					for (T const& item : other.data){
-					    data.emplace_back(
-					        std::make_obj_using_allocator<T>(
-					            pmr::allocator_type<T>{memResourcePtr},
-					            item
-					        )
-					    );
-					}
-
-				    std::unordered_map<T const*, iterator> iterMap;
-				    iterMap.reserve(other.access.sz);
-				
-					const_iterator oldIt {other.data.cbegin()};
-				    iterator newIt {data.begin()};
-				    for (; oldIt != other.data.cend(); ++oldIt, ++newIt) {
-				        iterMap[std::addressof(*oldIt)] = newIt;
-					}
-				
-				    access.sz            = other.access.sz;
-				    access.deleted_count = other.access.deleted_count;
-				
-				    for (std::size_t i {0}; i < other.access.capacityPolicy.capacity(); ++i) {
-				        Element<iterator> const& elem {other.access.accessHelper[i]};
-				        if (elem.has_value()) {
-				            access.accessHelper[i].emplace(iterMap.at(std::addressof(*elem.value())));
-						}
-				        else if (elem.is_deleted()) {
-				            access.accessHelper[i].reset();
-						}
-				    }
+					access.copyFrom(other.access);
 				}
 
 				HashTable& operator=(HashTable const& other) {
@@ -589,68 +2378,54 @@ namespace containers {
 					}
 
 					data.clear();
-					for (T const& item : other.data) {
-					    data.emplace_back(
-					        std::make_obj_using_allocator<T>(
-					            pmr::allocator_type<T>{memResourcePtr},
-					            item
-					        )
-					    );
-					}
-				
-				    access.accessHelper.assign(other.access.capacityPolicy.capacity(), {});
-				    access.capacityPolicy = other.access.capacityPolicy;
-				    access.sz            = other.access.sz;
-				    access.deleted_count = other.access.deleted_count;
-				
-				    std::unordered_map<T const*, iterator> iterMap;
-				    iterMap.reserve(other.access.sz);
-				
-					const_iterator oldIt {other.data.cbegin()};
-				    iterator newIt {data.begin()};
-				    for (; oldIt != other.data.cend(); ++oldIt, ++newIt) {
-				        iterMap[std::addressof(*oldIt)] = newIt;
-					}
-				
-				    for (std::size_t i {0}; i < other.access.capacityPolicy.capacity(); ++i) {
-				        Element<iterator> const& elem {other.access.accessHelper[i]};
-				        if (elem.has_value()) {
-				            access.accessHelper[i].emplace(iterMap.at(std::addressof(*elem.value())));
-						}
-				        else if (elem.is_deleted()) {
-				            access.accessHelper[i].reset();
-						}
-				    }
+					access.deadNodes.clear();
+					access.copyFrom(other.access);
 
 					return *this;
 				}
 
+				//other is left empty and without an index, so nothing is allocated here
 				HashTable(HashTable&& other) noexcept
 				    // : data(pmr::allocator_type{&pmr::resource})
 					: memResourcePtr (other.memResourcePtr)
 					, data(pmr::allocator_type<T>{memResourcePtr})
-				    , access(data, 0, memResourcePtr)
+				    , access(data, std::move(other.access))
 				{
 				    data.splice(data.end(), other.data);
-					access.deadNodes.clear();
-				    access.accessHelper = std::move(other.access.accessHelper);
-				    access.capacityPolicy = other.access.capacityPolicy;
-				    access.sz = other.access.sz;
-				    access.deleted_count = other.access.deleted_count;
 				}
 
-				HashTable& operator=(HashTable&& other) noexcept 
-				{
+				//not noexcept, as std::pmr containers: tables on different resources move the elements one by one
+				HashTable& operator=(HashTable&& other) {
 				    if (this == &other) {
 				        return *this;
 				    }
-				    data.clear();
+					access.clear();
+					if (data.get_allocator() != other.data.get_allocator()) {
+						//nodes can't travel between resources, so elements are moved one by one
+						for (typename Data::iterator iter {other.data.begin()}; iter != other.data.end(); ++iter) {
+							data.emplace_back(std::move(*iter));
+						}
+						other.data.clear();
+						access.capacityPolicy = other.access.capacityPolicy;
+						access.sz = other.access.sz;
+						access.autoTrimFrom = other.access.autoTrimFrom;
+						access.deferredMaintenance = other.access.deferredMaintenance;
+						access.parallelRehashFrom = other.access.parallelRehashFrom;
+						access.rehashThreads = other.access.rehashThreads;
+						access.reindex();
+						other.access.reset();
+						return *this;
+					}
 				    data.splice(data.end(), other.data);
-					access.deadNodes.clear();					
 				    access.accessHelper = std::move(other.access.accessHelper);
 				    access.capacityPolicy = other.access.capacityPolicy;
 				    access.sz = other.access.sz;
 				    access.deleted_count = other.access.deleted_count;
+					access.autoTrimFrom = other.access.autoTrimFrom;
+					access.deferredMaintenance = other.access.deferredMaintenance;
+					access.parallelRehashFrom = other.access.parallelRehashFrom;
+					access.rehashThreads = other.access.rehashThreads;
+					other.access.reset();
 				    return *this;
 				}
 
@@ -658,9 +2433,152 @@ namespace containers {
 				requires 
 					(sizeof...(Args) > 0) &&
 					std::constructible_from<T, Args...> && 
-					(!std::same_as<T, std::remove_cvref_t<Args>> && ...)
+					(!std::same_as<T, std::remove_cvref_t<Args>> && ...) &&
+					(!requirements::is_iterator_pair_v<Args...>)
 				std::pair<iterator, bool> insert(Args&&... args) {
-					return access.insert(T(std::forward<Args>(args)...));
+					return access.emplace(std::forward<Args>(args)...);
+				}
+
+				/**
+				 * The element is taken out with its node, see node_type, other iterators stay valid.
+				 * */
+				node_type extract(const_iterator pos) { return access.extract(pos); }
+
+				node_type extract(key_type const& key) {
+					const_iterator found {std::as_const(*this).find(key)};
+					return found == this->cend() ? node_type{} : access.extract(found);
+				}
+
+				/**
+				 * If the key is already here, the node is given back in the result.
+				 * */
+				insert_return_type insert(node_type&& node) { return access.insertNode(std::move(node)); }
+
+				void merge(HashTable& other) { access.merge(other.access); }
+
+				void merge(HashTable&& other) { access.merge(other.access); }
+
+				/**
+				 * Merge of the tables whose keys are known to be in none of the others and not here, ie partials
+				 * aggregated per hash partition: no keys are compared, the elements are placed into the index
+				 * on threads. Nodes are relinked from the tables with the same node resource, values of the rest
+				 * are moved on the calling thread. A duplicate breaks the table. Others are left empty.
+				 * */
+				template <std::ranges::input_range Tables>
+				requires requirements::IsUniqueConcept<type> && std::derived_from<std::ranges::range_value_t<Tables>, HashTable> &&
+				std::is_lvalue_reference_v<std::ranges::range_reference_t<Tables>>
+				void merge_unique_unchecked(Tables&& others, std::size_t threads = std::thread::hardware_concurrency()) {
+					std::vector<Access*> sources;
+					for (HashTable &other : others) {
+						if (&other != this) {
+							sources.push_back(&other.access);
+						}
+					}
+					access.mergeUnchecked(sources, threads);
+				}
+
+				/**
+				 * Constructs the value right in the list node, no temporary T is moved around.
+				 * */
+				template<typename... Args>
+				requires std::constructible_from<T, Args...>
+				std::pair<iterator, bool> emplace(Args&&... args) {
+					return access.emplace(std::forward<Args>(args)...);
+				}
+
+				/**
+				 * Mapped value is constructed from args in place and only if the key is not there yet,
+				 * either way there is a single probe.
+				 * */
+				template<typename... Args>
+				requires requirements::IsMapConcept<type> && requirements::IsUniqueConcept<type> && std::constructible_from<mapped_type, Args...>
+				std::pair<iterator, bool> try_emplace(key_type const& key, Args&&... args) {
+					return access.tryEmplace(key, std::forward<Args>(args)...);
+				}
+
+				template<typename... Args>
+				requires requirements::IsMapConcept<type> && requirements::IsUniqueConcept<type> && std::constructible_from<mapped_type, Args...>
+				std::pair<iterator, bool> try_emplace(std::remove_cv_t<key_type>&& key, Args&&... args) {
+					return access.tryEmplace(std::move(key), std::forward<Args>(args)...);
+				}
+
+				template<typename M>
+				requires requirements::IsMapConcept<type> && requirements::IsUniqueConcept<type> && std::assignable_from<mapped_type&, M&&> && std::constructible_from<mapped_type, M&&>
+				std::pair<iterator, bool> insert_or_assign(key_type const& key, M&& obj) {
+					auto result {access.tryEmplace(key, std::forward<M>(obj))};
+					if (!result.second) {
+						result.first->second = std::forward<M>(obj);
+					}
+					return result;
+				}
+
+				template<typename M>
+				requires requirements::IsMapConcept<type> && requirements::IsUniqueConcept<type> && std::assignable_from<mapped_type&, M&&> && std::constructible_from<mapped_type, M&&>
+				std::pair<iterator, bool> insert_or_assign(std::remove_cv_t<key_type>&& key, M&& obj) {
+					auto result {access.tryEmplace(std::move(key), std::forward<M>(obj))};
+					if (!result.second) {
+						result.first->second = std::forward<M>(obj);
+					}
+					return result;
+				}
+
+				/**
+				 * Bulk insert, index is resized once for the whole input and keys are placed region by region,
+				 * so it is much faster than inserting one by one for big ranges. If many of the keys were
+				 * duplicates, the index is rebuilt once more, to the size that fits the elements taken.
+				 * */
+				template <std::input_iterator InputIt, std::sentinel_for<InputIt> Sentinel>
+				requires std::constructible_from<T, std::iter_reference_t<InputIt>>
+				void insert(InputIt first, Sentinel last) {
+					access.insertBulk(std::move(first), std::move(last));
+				}
+
+				template <std::ranges::input_range Range>
+				requires std::constructible_from<T, std::ranges::range_reference_t<Range>>
+				void insert_range(Range&& range) {
+					access.insertBulk(std::ranges::begin(range), std::ranges::end(range));
+				}
+
+				/**
+				 * Same as insert(first, last), but hashing, partitioning and deduplication of the keys, and placing
+				 * of the new nodes into the index are spread over threads, the calling thread included; the nodes
+				 * themselves are made on the calling thread. Worth it for millions of elements,
+				 * a small input, or a multi table, goes the usual way. Input keys are of key_type,
+				 * the hasher and key_equal are called from several threads at once.
+				 * */
+				template <std::random_access_iterator InputIt>
+				requires std::constructible_from<T, std::iter_reference_t<InputIt>> &&
+				std::same_as<std::remove_cvref_t<decltype(Access::keyOfInput(*std::declval<InputIt>()))>, std::remove_cv_t<key_type>>
+				void build_parallel(InputIt first, InputIt last, std::size_t threads = std::thread::hardware_concurrency()) {
+					std::size_t const count {static_cast<std::size_t>(std::distance(first, last))};
+					if constexpr (requirements::IsUniqueConcept<type>) {
+						if (parallel::chunksFor(threads, count, const_values::parallelMinChunk) > 1) {
+							access.insertParallel(first, count, threads);
+							return;
+						}
+					}
+					access.insertBulk(first, last);
+				}
+
+				/**
+				 * Load of the keys known to be unique and not in the table yet, ie from a snapshot:
+				 * no keys are compared, each value goes to the first free slot of its probe sequence.
+				 * A duplicate breaks the table, it is caught by assert in debug builds only.
+				 * */
+				iterator insert_unique_unchecked(T value)
+				requires requirements::IsUniqueConcept<type>
+				{
+					return access.insertUnchecked(std::move(value));
+				}
+
+				template <std::input_iterator InputIt, std::sentinel_for<InputIt> Sentinel>
+				requires std::constructible_from<T, std::iter_reference_t<InputIt>> && requirements::IsUniqueConcept<type>
+				void insert_unique_unchecked(InputIt first, Sentinel last) {
+					access.template insertBulk<true>(std::move(first), std::move(last));
+				}
+
+				void insert(std::initializer_list<T> values) {
+					access.insertBulk(values.begin(), values.end());
 				}
 
 				std::pair<iterator, bool> insert(T value) {
@@ -677,6 +2595,19 @@ namespace containers {
 
 				void erase(const_iterator const cIter) { access.erase(cIter); }
 
+				/**
+				 * Bulk erases: slots are marked and nodes unlinked in one pass, then the index is resized
+				 * at most once, not from within every erase.
+				 * */
+				iterator erase(const_iterator first, const_iterator last) { return access.erase(first, last); }
+
+				//returns number of keys erased
+				std::size_t erase_many(std::span<key_type const> keys) { return access.eraseMany(keys); }
+
+				template <typename Pred>
+				requires std::predicate<Pred&, T const&>
+				friend std::size_t erase_if(HashTable& table, Pred pred) { return table.access.eraseIf(pred); }
+
 				bool contains(key_type const &key) const{ return access.contains(key); }
 
 				const_iterator at(key_type const& key) const {
@@ -687,6 +2618,213 @@ namespace containers {
 					return found;
 				}
 
+				/**
+				 * All the elements with the key, those are adjacent. For unique keys there is one at most.
+				 * */
+				std::pair<iterator, iterator> equal_range(key_type const& key)
+				requires requirements::IsMapConcept<type>
+				{ return access.equalRange(key); }
+
+				std::pair<const_iterator, const_iterator> equal_range(key_type const& key) const { return access.equalRange(key); }
+
+				std::size_t count(key_type const& key) const {
+					auto [first, last] {access.equalRange(key)};
+					return static_cast<std::size_t>(std::distance(first, last));
+				}
+
+				/**
+				 * Heterogeneous lookup, enabled when both Hasher and KeyEqual declare is_transparent,
+				 * ie Map<std::string, V, StringHash, std::equal_to<>> is searched by std::string_view or char const*
+				 * with no temporary std::string.
+				 * */
+				template <typename K>
+				requires is_transparent_lookup_v<K> && requirements::IsMapConcept<type>
+				iterator find(K const& key) { return access.find(key); }
+
+				template <typename K>
+				requires is_transparent_lookup_v<K>
+				const_iterator find(K const& key) const { return access.find(key); }
+
+				template <typename K>
+				requires is_transparent_lookup_v<K>
+				void erase(K const& key) { access.erase(key); }
+
+				template <typename K>
+				requires is_transparent_lookup_v<K>
+				bool contains(K const& key) const { return access.contains(key); }
+
+				template <typename K>
+				requires is_transparent_lookup_v<K>
+				const_iterator at(K const& key) const {
+					const_iterator found {find(key)};
+					if (found == this->cend()) {
+						throw std::out_of_range("Hash table, method at() gets non-existent key");
+					}
+					return found;
+				}
+
+				/**
+				 * Same as above, but with the hash computed by the caller, so a key that goes to several tables
+				 * is hashed once. The hash has to be hash_function()(key), the table can't check it.
+				 * */
+				template <typename K>
+				requires is_lookup_key_v<K> && requirements::IsMapConcept<type>
+				iterator find(K const& key, std::size_t hash) { return access.find(key, hash); }
+
+				template <typename K>
+				requires is_lookup_key_v<K>
+				const_iterator find(K const& key, std::size_t hash) const { return access.find(key, hash); }
+
+				template <typename K>
+				requires is_lookup_key_v<K>
+				void erase(K const& key, std::size_t hash) { access.erase(key, hash); }
+
+				template <typename K>
+				requires is_lookup_key_v<K>
+				bool contains(K const& key, std::size_t hash) const { return access.contains(key, hash); }
+
+				std::pair<iterator, bool> insert_with_hash(T value, std::size_t hash) {
+					return access.insert(std::move(value), hash);
+				}
+
+				//try_emplace() with the hash known, a single probe and no value built if the key is there
+				template<typename... Args>
+				requires requirements::IsMapConcept<type> && requirements::IsUniqueConcept<type> && std::constructible_from<mapped_type, Args...>
+				std::pair<iterator, bool> try_emplace_with_hash(key_type const& key, std::size_t hash, Args&&... args) {
+					return access.tryEmplaceHashed(hash, key, std::forward<Args>(args)...);
+				}
+
+				hasher hash_function() const { return access.hasher; }
+
+				key_equal key_eq() const { return access.equal; }
+
+				/**
+				 * Keeps capacity. For trivially destructible types it is O(1) on the nodes side —
+				 * they are kept aside and reused by the following inserts, otherwise values are destroyed right away.
+				 * */
+				void clear() { access.clear(); }
+
+				/**
+				 * Gives memory that is not in use back: shrinks the index if the load allows,
+				 * drops parked dead nodes and asks the node resource to return its empty chunks upstream,
+				 * if it is a pmr::TrimmableMemoryResource. The default shared pool is one.
+				 * Returns bytes the node resource gave back.
+				 * */
+				std::size_t trim() {
+					access.shrink();
+					return access.releaseUnused();
+				}
+
+				//trim() automatically each time index shrinks from fromCapacity or more, 0 turns it off
+				void setAutoTrim(std::size_t fromCapacity) { access.autoTrimFrom = fromCapacity; }
+
+				/**
+				 * Deferred maintenance, for an owner that does it out of the hot path, i.e. on a background thread:
+				 * erase() doesn't shrink the index and doesn't purge tombstones anymore, that's what maintain() does.
+				 * maintain() also grows the index ahead, once the load is over the watermark, so an insert
+				 * rehashes on its own only when the load gets to maxLoadFactor regardless, as an emergency.
+				 * */
+				void setDeferredMaintenance(bool deferred) { access.deferredMaintenance = deferred; }
+
+				/**
+				 * Rehash of a table of fromSize elements or more is spread over threads, the hasher is then
+				 * called from several threads at once. 0 turns it off, as it is by default.
+				 * */
+				void setParallelRehash(std::size_t fromSize, std::size_t threads = std::thread::hardware_concurrency()) {
+					access.parallelRehashFrom = fromSize;
+					access.rehashThreads = std::max<std::size_t>(threads, 1);
+				}
+
+				bool needsMaintenance(double watermark) const {
+					checkWatermark(watermark);
+					return access.needsMaintenance(watermark);
+				}
+
+				//true if there was something to do
+				bool maintain(double watermark) {
+					checkWatermark(watermark);
+					return access.maintain(watermark);
+				}
+
+				/**
+				 * Batched find(), result[i] is for keys[i]. For the tables that don't fit in cache it gets more lookups
+				 * per second, than calling find() in a loop, as the memory latency of the lookups in a batch is overlapped.
+				 * */
+				void find_many(std::span<key_type const> keys, std::span<const_iterator> result) const {
+					if (result.size() < keys.size()) {
+						throw std::invalid_argument("Hash table, method find_many() gets result shorter than keys");
+					}
+					auto emit = [&result](std::size_t idx, const_iterator found) { result[idx] = found; };
+					access.findMany(keys, emit);
+				}
+
+				//bit i is set if keys[i] is found, up to 64 keys per call
+				std::uint64_t contains_many(std::span<key_type const> keys) const {
+					if (keys.size() > sizeof(std::uint64_t) * CHAR_BIT) {
+						throw std::invalid_argument("Hash table, method contains_many() gets more than 64 keys");
+					}
+					std::uint64_t mask {0};
+					const_iterator const last {data.cend()};
+					auto emit = [&mask, &last](std::size_t idx, const_iterator found) {
+						mask |= std::uint64_t{found != last} << idx;
+					};
+					access.findMany(keys, emit);
+					return mask;
+				}
+
+				/**
+				 * Makes room for count elements, so there is no rehash until then.
+				 * With reserveNodes set the node resource is also asked to get memory for the nodes in advance,
+				 * it works if the resource is a pmr::TrimmableMemoryResource, as the default one is.
+				 * */
+				void reserve(std::size_t count, bool reserveNodes = false) {
+					access.reserve(count);
+					if (reserveNodes) {
+						access.reserveNodes(count);
+					}
+				}
+
+				//sets capacity to at least buckets, but not less than size() requires, tombstones are gone
+				void rehash(std::size_t buckets) {
+					access.rehashTo(std::max(std::bit_ceil(buckets), access.capacityFor(access.sz)));
+				}
+
+				/**
+				 * n disjoint parts, that cover the table together, one per thread i.e. They are split by the index,
+				 * so there is no walk over the elements to get them, and are about equal by the element count.
+				 * */
+				std::vector<partition_view> partitions(std::size_t n) const {
+					n = std::clamp<std::size_t>(n, 1, std::max<std::size_t>(access.accessHelper.size(), 1));
+					std::vector<partition_view> result;
+					result.reserve(n);
+					for (std::size_t i {0}; i != n; ++i) {
+						result.push_back(partition_view{&access,
+							parallel::chunkBound(i, n, access.accessHelper.size()),
+							parallel::chunkBound(i + 1, n, access.accessHelper.size())});
+					}
+					return result;
+				}
+
+				/**
+				 * fn(value) for every element, on threads. The table is split into more parts than threads,
+				 * and a thread that is done with its part takes the next one, so the threads finish about together.
+				 * fn is called concurrently, there should be no inserts or erases meanwhile.
+				 * */
+				template <typename Fn>
+				void parallel_for_each(Fn fn, std::size_t threads = std::thread::hardware_concurrency()) const {
+					//not a constraint, so a generic lambda that updates a map's values doesn't get instantiated for this one
+					static_assert(std::invocable<Fn&, T const&>, "parallel_for_each() requires fn(value_type const&)");
+					auto visit = [&fn](T const& value) { fn(value); };
+					forEachPart(visit, threads);
+				}
+
+				//a map gets its values updated in place, each element is visited by one thread only
+				template <typename Fn>
+				requires requirements::IsMapConcept<type> && std::invocable<Fn&, T&>
+				void parallel_for_each(Fn fn, std::size_t threads = std::thread::hardware_concurrency()) {
+					forEachPart(fn, threads);
+				}
+
 				std::size_t size() const{ return access.sz; }
 
 				std::size_t capacity() const { return access.capacityPolicy.capacity(); }
@@ -695,6 +2833,30 @@ namespace containers {
 
 				std::size_t bytesAllocated() const { return access.bytesAllocated(); }
 
+				std::pmr::memory_resource* nodeResource() const { return memResourcePtr; }
+
+				std::pmr::memory_resource* indexResource() const { return access.accessHelper.get_allocator().resource(); }
+
+				/**
+				 * The only operation that DOES invalidate pointers and iterators. Moves all the elements
+				 * into freshly allocated nodes, placed in iteration order, dropping tombstones and parked nodes.
+				 * Each move is reported as relocate(oldAddress, newAddress) to let the owners of external
+				 * pointers to patch them, once the table is compacted, so a throwing relocate only stops the reports.
+				 * If a new node can't be made, the table is left as it was. Every compaction bumps epoch(),
+				 * the table itself doesn't check iterators against it, one can keep an epoch along with
+				 * stored iterators and compare it in debug builds.
+				 * */
+				template <typename Relocate>
+				requires std::invocable<Relocate&, T const*, T const*>
+				void compact(Relocate&& relocate) { access.compact(relocate); }
+
+				void compact() {
+					auto noop = [](T const*, T const*) {};
+					access.compact(noop);
+				}
+
+				std::size_t epoch() const { return access.epoch; }
+
 				iterator begin() requires requirements::IsMapConcept<type> { return data.begin(); }
 
 				iterator end() requires requirements::IsMapConcept<type> { return data.end(); }
@@ -720,6 +2882,22 @@ namespace containers {
 				const_reverse_iterator crend() const { return data.crend(); }
 
 			private:
+				template <typename Fn>
+				void forEachPart(Fn &fn, std::size_t threads) const {
+					std::size_t const
+						slots {access.accessHelper.size()},
+						parts {std::min(slots, std::max<std::size_t>(threads, 1) * const_values::parallelPartitionsPerThread)};
+					parallel::forTasks(threads, parts, [this, &fn, slots, parts](std::size_t part) {
+						access.visitSlots(parallel::chunkBound(part, parts, slots), parallel::chunkBound(part + 1, parts, slots), fn);
+					});
+				}
+
+				static void checkWatermark(double watermark) {
+					if (!(watermark > 0.0 && watermark < const_values::maxLoadFactor)) {
+						throw std::invalid_argument("Hash table, maintenance watermark should be within (0, maxLoadFactor)");
+					}
+				}
+
 				std::pmr::memory_resource* memResourcePtr;
 				Data data;
 				Access access;
@@ -781,19 +2959,67 @@ namespace containers {
 
 			using base_type::base_type;
 
+			//single probe, Value{} is constructed only for a new key
 			Value& operator[](Key const& key)
 			requires std::default_initializable<Value>
 			{
-				iterator found {this->find(key)};
-				if (found != this->end()) {
-					return found->second;
-				}
+				return this->try_emplace(key).first->second;
+			}
 
-				auto [inserted, ok] {this->insert(value_type{key, Value{}} )};
-				return inserted->second;
+			Value& operator[](Key&& key)
+			requires std::default_initializable<Value>
+			{
+				return this->try_emplace(std::move(key)).first->second;
 			}
 		};
 
+		/**
+		 * Equal keys are allowed, their nodes are adjacent in the list and keep insertion order among themselves,
+		 * the index has one slot per distinct key. Iterators and pointers are as stable as in Set and Map.
+		 * */
+		template <typename T, typename Hasher = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+		requires
+		::requirements::hash::IsHash<T, Hasher, std::size_t> &&
+		std::predicate<KeyEqual, T, T>
+		struct MultiSet final : public details::HashTable<T, Hasher, KeyEqual, details::requirements::Type::MultiSet> 
+		{
+		private:
+			using base_type = details::HashTable<T, Hasher, KeyEqual, details::requirements::Type::MultiSet>;
+		public:
+			using key_type = typename base_type::key_type;
+			using value_type = typename base_type::value_type;
+			using hasher = typename base_type::hasher;
+			using key_equal = typename base_type::key_equal;
+			using iterator = typename base_type::iterator;
+			using const_iterator = typename base_type::const_iterator;
+			using reverse_iterator = typename base_type::reverse_iterator;
+			using const_reverse_iterator = typename base_type::const_reverse_iterator;
+
+			using base_type::base_type;
+		};
+
+		template <typename Key, typename Value, typename Hasher = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+		requires
+		::requirements::hash::IsHash<Key, Hasher, std::size_t> &&
+		std::predicate<KeyEqual, Key, Key>
+		struct MultiMap final : public details::HashTable<std::pair<Key const, Value>, Hasher, KeyEqual, details::requirements::Type::MultiMap> 
+		{
+		private:
+			using base_type = details::HashTable<std::pair<Key const, Value>, Hasher, KeyEqual, details::requirements::Type::MultiMap>;
+		public:
+			using key_type = typename base_type::key_type;
+			using mapped_type = typename base_type::mapped_type;
+			using value_type = typename base_type::value_type;
+			using hasher = typename base_type::hasher;
+			using key_equal = typename base_type::key_equal;
+			using iterator = typename base_type::iterator;
+			using const_iterator = typename base_type::const_iterator;
+			using reverse_iterator = typename base_type::reverse_iterator;
+			using const_reverse_iterator = typename base_type::const_reverse_iterator;
+
+			using base_type::base_type;
+		};
+
 	}//!namespace hash_table
 
 }//!namespace containers
@@ -485,4 +485,100 @@ TEST(capacity_bytes_map, differentValueSizesAffectElementSize) {
 	std::size_t bigElementSize {bigMap.bytesAllocated() / bigMap.capacity()};
 
 	ASSERT_EQ(smallElementSize, bigElementSize);
-}
\ No newline at end of file
+}
+
+TEST(capacity_reserve, reserveAvoidsRehash) {
+	::containers::hash_table::Map<int, int> hashTable;
+	hashTable.reserve(10'000);
+	std::size_t const reserved {hashTable.capacity()};
+	ASSERT_TRUE(CP::isPowerOfTwo(reserved));
+	ASSERT_GE(reserved * ::containers::hash_table::details::const_values::maxLoadFactor, 10'000.0);
+
+	auto [first, _] {hashTable.insert(0, 0)};
+	for (int i {1}; i != 10'000; ++i) {
+		hashTable.insert(i, i);
+		ASSERT_EQ(hashTable.capacity(), reserved);
+	}
+	ASSERT_EQ(first, hashTable.find(0));
+
+	//reserve never shrinks
+	hashTable.reserve(10);
+	ASSERT_EQ(hashTable.capacity(), reserved);
+}
+
+TEST(capacity_reserve, rehash) {
+	::containers::hash_table::Set<int> hashTable;
+	for (int i {0}; i != 100; ++i) {
+		hashTable.insert(i);
+	}
+	hashTable.rehash(1'000);
+	ASSERT_EQ(hashTable.capacity(), 1'024u);
+
+	//can't go below what size requires
+	hashTable.rehash(0);
+	ASSERT_EQ(hashTable.capacity(), 256u);
+	for (int i {0}; i != 100; ++i) {
+		ASSERT_TRUE(hashTable.contains(i));
+	}
+}
+
+TEST(capacity_reserve, deferredMaintenance) {
+	::containers::hash_table::Set<int> hashTable;
+	double const watermark {0.375};
+	for (int i {0}; i != 1'000; ++i) {
+		hashTable.insert(i);
+	}
+	std::size_t const grown {hashTable.capacity()};
+
+	//erase doesn't shrink, maintain() does
+	hashTable.setDeferredMaintenance(true);
+	for (int i {100}; i != 1'000; ++i) {
+		hashTable.erase(i);
+	}
+	ASSERT_EQ(hashTable.capacity(), grown);
+	ASSERT_TRUE(hashTable.needsMaintenance(watermark));
+	ASSERT_TRUE(hashTable.maintain(watermark));
+	ASSERT_LT(hashTable.capacity(), grown);
+	ASSERT_FALSE(hashTable.needsMaintenance(watermark));
+	ASSERT_FALSE(hashTable.maintain(watermark));
+
+	//growth ahead of maxLoadFactor
+	std::size_t const shrunk {hashTable.capacity()};
+	int key {100};
+	while (hashTable.size() <= shrunk * watermark) {
+		hashTable.insert(key++);
+	}
+	ASSERT_EQ(hashTable.capacity(), shrunk);
+	ASSERT_TRUE(hashTable.maintain(watermark));
+	ASSERT_EQ(hashTable.capacity(), shrunk << 1);
+	for (int i {0}; i != key; ++i) {
+		ASSERT_TRUE(hashTable.contains(i));
+	}
+
+	ASSERT_THROW(hashTable.maintain(0.5), std::invalid_argument);
+}
+
+TEST(capacity_reserve, parallelRehash) {
+	::containers::hash_table::Set<std::string> parallel, sequential;
+	parallel.setParallelRehash(1<<15, 4);
+	for (int i {0}; i != 200'000; ++i) {
+		parallel.insert(std::to_string(i));
+		sequential.insert(std::to_string(i));
+	}
+	ASSERT_EQ(parallel.capacity(), sequential.capacity());
+
+	//shrinks go the same way
+	for (int i {0}; i != 150'000; ++i) {
+		parallel.erase(std::to_string(i));
+	}
+	parallel.rehash(0);
+	ASSERT_EQ(parallel.size(), 50'000u);
+	for (int i {0}; i != 200'000; ++i) {
+		ASSERT_EQ(parallel.contains(std::to_string(i)), i >= 150'000);
+	}
+	parallel.reserve(400'000);
+	for (int i {150'000}; i != 200'000; ++i) {
+		ASSERT_TRUE(parallel.contains(std::to_string(i)));
+	}
+	ASSERT_EQ(parallel.size(), 50'000u);
+}
@@ -0,0 +1,517 @@
+//
+// Concurrent variants of the hash table
+//
+
+#include <gtest/gtest.h>
+#include "../include/concurrent_hash_table.hpp"
+
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <memory_resource>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+	struct Tally {
+		static inline int moves {0};
+		int count {0};
+		Tally() = default;
+		Tally(Tally&& other) noexcept : count {other.count} { ++moves; }
+		Tally& operator=(Tally&&) noexcept = default;
+	};
+
+	struct CopyCountingHash {
+		static inline std::atomic<int> copies {0};
+		CopyCountingHash() = default;
+		CopyCountingHash(CopyCountingHash const&) noexcept { ++copies; }
+		CopyCountingHash& operator=(CopyCountingHash const&) noexcept = default;
+		std::size_t operator()(int key) const { return std::hash<int>{}(key); }
+	};
+}
+
+TEST(hash_table_concurrent, sharded_map_upsert) {
+	::containers::hash_table::ConcurrentMap<int, int> counters (8);
+	ASSERT_EQ(counters.shard_count(), 8u);
+
+	int const threadCount {8}, perThread {20'000};
+	std::vector<std::thread> threads;
+	for (int t {0}; t != threadCount; ++t) {
+		threads.emplace_back([&counters] {
+			for (int i {0}; i != perThread; ++i) {
+				counters.upsert(i % 1'000, [](int &count) { ++count; });
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	ASSERT_EQ(counters.size(), 1'000u);
+	for (int key {0}; key != 1'000; ++key) {
+		int count {0};
+		ASSERT_TRUE(counters.visit(key, [&count](auto const& kv) { count = kv.second; }));
+		ASSERT_EQ(count, threadCount * perThread / 1'000);
+	}
+	ASSERT_FALSE(counters.visit(1'000, [](auto const&) {}));
+
+	//the value is built in its node, not built aside and moved there
+	::containers::hash_table::ConcurrentMap<int, Tally> tallies;
+	ASSERT_TRUE(tallies.upsert(1, [](Tally &tally) { ++tally.count; }));
+	ASSERT_FALSE(tallies.upsert(1, [](Tally &tally) { ++tally.count; }));
+	ASSERT_EQ(Tally::moves, 0);
+	ASSERT_TRUE(tallies.visit(1, [](auto const& kv) { ASSERT_EQ(kv.second.count, 2); }));
+}
+
+TEST(hash_table_concurrent, sharded_map_readers_and_writers) {
+	::containers::hash_table::ConcurrentMap<int, std::string> hashTable;
+	int const keys {20'000};
+	for (int i {0}; i != keys; i += 2) {
+		ASSERT_TRUE(hashTable.insert(i, std::to_string(i)));
+	}
+	ASSERT_FALSE(hashTable.insert(0, "zero"));
+
+	//address of a value doesn't change while the others come and go
+	std::string const* address {nullptr};
+	hashTable.visit(10, [&address](auto const& kv) { address = &kv.second; });
+
+	std::atomic<bool> failed {false};
+	std::vector<std::thread> threads;
+	for (int t {0}; t != 2; ++t) {
+		threads.emplace_back([&hashTable, t] {
+			for (int i {1 + t * 2}; i < keys; i += 4) {
+				hashTable.insert(i, std::to_string(i));
+			}
+		});
+	}
+	for (int t {0}; t != 4; ++t) {
+		threads.emplace_back([&hashTable, &failed] {
+			for (int i {0}; i < keys; i += 2) {
+				bool const visited {hashTable.visit(i, [&failed, i](auto const& kv) {
+					if (kv.second != std::to_string(i)) {
+						failed = true;
+					}
+				})};
+				if (!visited) {
+					failed = true;
+				}
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	ASSERT_FALSE(failed);
+	ASSERT_EQ(hashTable.size(), static_cast<std::size_t>(keys));
+	hashTable.visit(10, [address](auto const& kv) { ASSERT_EQ(&kv.second, address); });
+
+	std::size_t const erased {hashTable.erase_if([](auto const& kv) { return kv.first % 2 == 1; })};
+	ASSERT_EQ(erased, static_cast<std::size_t>(keys / 2));
+	ASSERT_TRUE(hashTable.erase(10));
+	ASSERT_FALSE(hashTable.erase(10));
+	ASSERT_FALSE(hashTable.contains(11));
+	ASSERT_TRUE(hashTable.contains(12));
+
+	std::size_t visited {0};
+	hashTable.for_each([&visited](auto const&) { ++visited; });
+	ASSERT_EQ(visited, hashTable.size());
+	hashTable.clear();
+	ASSERT_TRUE(hashTable.empty());
+}
+
+TEST(hash_table_concurrent, sharded_set) {
+	::containers::hash_table::ConcurrentSet<std::string> hashTable (1);
+	ASSERT_EQ(hashTable.shard_count(), 1u);
+	std::vector<std::thread> threads;
+	for (int t {0}; t != 4; ++t) {
+		threads.emplace_back([&hashTable] {
+			for (int i {0}; i != 5'000; ++i) {
+				hashTable.insert(std::to_string(i));
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	ASSERT_EQ(hashTable.size(), 5'000u);
+	ASSERT_TRUE(hashTable.contains("4999"));
+	ASSERT_TRUE(hashTable.erase("4999"));
+	ASSERT_FALSE(hashTable.contains("4999"));
+
+	//the key of a set of pairs is the whole pair
+	struct PairHash {
+		std::size_t operator()(std::pair<int, int> const& value) const {
+			return std::hash<int>{}(value.first) * 31 + std::hash<int>{}(value.second);
+		}
+	};
+	::containers::hash_table::ConcurrentSet<std::pair<int, int>, PairHash> pairs;
+	ASSERT_TRUE(pairs.insert({1, 2}));
+	ASSERT_TRUE(pairs.insert({1, 3}));
+	ASSERT_FALSE(pairs.insert({1, 2}));
+	ASSERT_TRUE(pairs.contains({1, 3}));
+	ASSERT_EQ(pairs.size(), 2u);
+
+	//the hasher is not copied per operation
+	::containers::hash_table::ConcurrentSet<int, CopyCountingHash> counted;
+	int const copiesBefore {CopyCountingHash::copies};
+	for (int i {0}; i != 1'000; ++i) {
+		counted.insert(i);
+		ASSERT_TRUE(counted.contains(i));
+	}
+	ASSERT_EQ(CopyCountingHash::copies, copiesBefore);
+}
+
+TEST(hash_table_concurrent, sharded_maintenance) {
+	::containers::hash_table::ConcurrentSet<int> hashTable (4);
+	hashTable.start_maintenance(0.375, std::chrono::milliseconds{1});
+	ASSERT_THROW(hashTable.start_maintenance(), std::logic_error);
+
+	int const threadCount {4}, perThread {10'000};
+	std::vector<std::thread> threads;
+	for (int t {0}; t != threadCount; ++t) {
+		threads.emplace_back([&hashTable, t] {
+			for (int i {t * perThread}; i != (t + 1) * perThread; ++i) {
+				hashTable.insert(i);
+			}
+			for (int i {t * perThread}; i < (t + 1) * perThread; i += 2) {
+				hashTable.erase(i);
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	hashTable.stop_maintenance();
+	ASSERT_EQ(hashTable.size(), static_cast<std::size_t>(threadCount * perThread / 2));
+	for (int i {0}; i != threadCount * perThread; ++i) {
+		ASSERT_EQ(hashTable.contains(i), i % 2 == 1);
+	}
+	//may be started again
+	hashTable.start_maintenance();
+}
+
+TEST(hash_table_concurrent, single_writer_map) {
+	::containers::hash_table::SingleWriterMap<int, std::string> hashTable;
+	for (int i {0}; i != 1'000; ++i) {
+		ASSERT_TRUE(hashTable.insert(i, std::to_string(i)));
+	}
+	ASSERT_FALSE(hashTable.insert(0, "zero"));
+	ASSERT_EQ(hashTable.get(0), "0");
+
+	int const keys {50'000};
+	std::atomic<bool> done {false}, failed {false};
+	std::vector<std::thread> readers;
+	for (int t {0}; t != 4; ++t) {
+		readers.emplace_back([&] {
+			while (!done) {
+				for (int i {0}; i != 1'000; ++i) {
+					//the first thousand is always there, under one value or another
+					auto const value {hashTable.get(i)};
+					if (!value.has_value() || (*value != std::to_string(i) && *value != std::to_string(-i))) {
+						failed = true;
+					}
+				}
+				for (int i {1'000}; i < keys; i += 97) {
+					hashTable.visit(i, [&failed, i](auto const& kv) {
+						if (kv.first != i || kv.second != std::to_string(i)) {
+							failed = true;
+						}
+					});
+				}
+			}
+		});
+	}
+
+	//growth, updates, erases and shrinks, while being read
+	for (int i {1'000}; i != keys; ++i) {
+		hashTable.insert(i, std::to_string(i));
+		if (i % 3 == 0) {
+			hashTable.insert_or_assign(i % 1'000, std::to_string(-(i % 1'000)));
+		}
+	}
+	for (int i {1'000}; i != keys; ++i) {
+		ASSERT_TRUE(hashTable.erase(i));
+	}
+	done = true;
+	for (auto &reader : readers) {
+		reader.join();
+	}
+	ASSERT_FALSE(failed);
+	ASSERT_EQ(hashTable.size(), 1'000u);
+	ASSERT_FALSE(hashTable.contains(1'000));
+	ASSERT_FALSE(hashTable.erase(1'000));
+	hashTable.reclaim();
+}
+
+TEST(hash_table_concurrent, single_writer_set) {
+	::containers::hash_table::SingleWriterSet<std::string> hashTable (4);
+	ASSERT_EQ(hashTable.capacity(), 4u);
+	for (int i {0}; i != 100; ++i) {
+		hashTable.insert(std::to_string(i));
+	}
+	ASSERT_GE(hashTable.capacity(), 200u);
+	std::size_t found {0};
+	std::thread reader {[&] {
+		for (int i {0}; i != 100; ++i) {
+			found += hashTable.contains(std::to_string(i));
+		}
+	}};
+	reader.join();
+	ASSERT_EQ(found, 100u);
+}
+
+TEST(hash_table_concurrent, insert_only_set) {
+	::containers::hash_table::ConcurrentInsertOnlySet<std::uint64_t> hashTable (100'000);
+	ASSERT_GE(static_cast<double>(hashTable.capacity()) * 0.5, 100'000.0);
+
+	int const threadCount {4};
+	std::atomic<std::size_t> insertedTotal {0};
+	std::vector<std::thread> threads;
+	for (int t {0}; t != threadCount; ++t) {
+		threads.emplace_back([&hashTable, &insertedTotal, t] {
+			std::size_t inserted {0};
+			//each key is inserted by two threads
+			for (std::uint64_t i = t / 2; i < 100'000; ++i) {
+				inserted += hashTable.insert(i * 7);
+			}
+			insertedTotal += inserted;
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	ASSERT_EQ(insertedTotal.load(), 100'000u);
+	ASSERT_EQ(hashTable.size(), 100'000u);
+	for (std::uint64_t i {0}; i != 100'000; ++i) {
+		ASSERT_TRUE(hashTable.contains(i * 7));
+		ASSERT_FALSE(hashTable.contains(i * 7 + 1));
+	}
+
+	ASSERT_FALSE(hashTable.contains(std::numeric_limits<std::uint64_t>::max()));
+	ASSERT_TRUE(hashTable.insert(std::numeric_limits<std::uint64_t>::max()));
+	ASSERT_FALSE(hashTable.insert(std::numeric_limits<std::uint64_t>::max()));
+	ASSERT_TRUE(hashTable.contains(std::numeric_limits<std::uint64_t>::max()));
+
+	std::size_t visited {0};
+	hashTable.for_each([&visited](std::uint64_t) { ++visited; });
+	ASSERT_EQ(visited, 100'001u);
+
+	::containers::hash_table::ConcurrentInsertOnlySet<int> tiny (1);
+	for (int i {0}; i != 32; ++i) {
+		tiny.insert(i);
+	}
+	ASSERT_THROW(tiny.insert(32), std::length_error);
+}
+
+TEST(hash_table_concurrent, combining_map) {
+	using Combining = ::containers::hash_table::details::FlatCombiningHashTable<::containers::hash_table::Map<int, int>>;
+	//the forwarding constructor takes the arguments of the table only
+	static_assert(!std::is_constructible_v<Combining, Combining&>);
+	static_assert(std::is_constructible_v<Combining, std::size_t>);
+	static_assert(!std::is_convertible_v<std::size_t, Combining>);
+
+	::containers::hash_table::CombiningMap<int, int> counters;
+	//more threads than publication records
+	int const threadCount {40}, perThread {1'000};
+	std::vector<std::thread> threads;
+	for (int t {0}; t != threadCount; ++t) {
+		threads.emplace_back([&counters] {
+			for (int i {0}; i != perThread; ++i) {
+				counters.upsert(i % 100, [](int &count) { ++count; });
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	ASSERT_EQ(counters.size(), 100u);
+	for (int key {0}; key != 100; ++key) {
+		int count {0};
+		ASSERT_TRUE(counters.visit(key, [&count](auto const& kv) { count = kv.second; }));
+		ASSERT_EQ(count, threadCount * perThread / 100);
+	}
+	ASSERT_TRUE(counters.insert(100, 1));
+	ASSERT_FALSE(counters.insert(100, 2));
+	ASSERT_TRUE(counters.erase(100));
+	ASSERT_FALSE(counters.contains(100));
+}
+
+TEST(hash_table_concurrent, combining_set) {
+	::containers::hash_table::CombiningSet<std::string> hashTable;
+	int const threadCount {4}, keys {4'000};
+	std::atomic<int> inserted {0}, erased {0};
+	std::atomic<bool> failed {false};
+	std::barrier inserts {threadCount};
+	std::vector<std::thread> threads;
+	for (int t {0}; t != threadCount; ++t) {
+		threads.emplace_back([&, t] {
+			for (int i {0}; i != keys; ++i) {
+				inserted += hashTable.insert(std::to_string(i));
+			}
+			inserts.arrive_and_wait();
+			for (int i {t}; i < keys; i += threadCount) {
+				if (!hashTable.contains(std::to_string(i))) {
+					failed = true;
+				}
+				erased += hashTable.erase(std::to_string(i));
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	ASSERT_FALSE(failed);
+	ASSERT_EQ(inserted, keys);
+	ASSERT_EQ(erased, keys);
+	ASSERT_TRUE(hashTable.empty());
+}
+
+namespace {
+	//negative keys can't be hashed
+	struct PickyHash {
+		std::size_t operator()(int key) const {
+			if (key < 0) {
+				throw std::invalid_argument("negative key");
+			}
+			return std::hash<int>{}(key);
+		}
+	};
+}
+
+TEST(hash_table_concurrent, combining_exceptions) {
+	::containers::hash_table::CombiningSet<int, PickyHash> hashTable;
+	int const threadCount {8}, perThread {2'000};
+	std::atomic<int> thrown {0};
+	std::atomic<bool> failed {false};
+	std::vector<std::thread> threads;
+	for (int t {0}; t != threadCount; ++t) {
+		threads.emplace_back([&, t] {
+			for (int i {0}; i != perThread; ++i) {
+				int const key {i % 3 == 0 ? -i - 1 : t * perThread + i};
+				//the one that asked gets the error, the others are not affected, the combiner doesn't stay locked
+				try {
+					hashTable.insert(key);
+					failed = failed || key < 0;
+				}
+				catch (std::invalid_argument const&) {
+					thrown += key < 0;
+					failed = failed || key >= 0;
+				}
+				try {
+					failed = failed || !hashTable.contains(key);
+				}
+				catch (std::invalid_argument const&) {
+					thrown += key < 0;
+					failed = failed || key >= 0;
+				}
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	ASSERT_FALSE(failed);
+	ASSERT_EQ(thrown, 2 * threadCount * ((perThread + 2) / 3));
+	ASSERT_EQ(hashTable.size(), static_cast<std::size_t>(threadCount * (perThread - (perThread + 2) / 3)));
+	ASSERT_THROW(hashTable.contains(-1), std::invalid_argument);
+	ASSERT_TRUE(hashTable.contains(1));
+}
+
+TEST(hash_table_concurrent, partitioned_map) {
+	using PartitionedMap = ::containers::hash_table::PartitionedMap<int, std::string>;
+	PartitionedMap hashTable (4, 64);
+	ASSERT_EQ(hashTable.worker_count(), 4u);
+
+	int const threadCount {4}, perThread {2'000};
+	std::vector<std::thread> threads;
+	for (int t {0}; t != threadCount; ++t) {
+		threads.emplace_back([&hashTable, t] {
+			std::vector<std::future<bool>> inserted;
+			for (int i {t * perThread}; i != (t + 1) * perThread; ++i) {
+				inserted.push_back(hashTable.insert(i, std::to_string(i)));
+			}
+			for (auto &future : inserted) {
+				ASSERT_TRUE(future.get());
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	ASSERT_EQ(hashTable.size(), static_cast<std::size_t>(threadCount * perThread));
+	ASSERT_FALSE(hashTable.insert(0, "zero").get());
+	ASSERT_EQ(hashTable.find(42).get(), std::optional<std::string>{"42"});
+	ASSERT_FALSE(hashTable.find(-1).get().has_value());
+	ASSERT_TRUE(hashTable.erase(42).get());
+	ASSERT_FALSE(hashTable.erase(42).get());
+
+	//requests for one key are executed in the order of submission
+	hashTable.post(7, [](PartitionedMap::partition_type &partition) { partition[7] += "+"; });
+	ASSERT_EQ(hashTable.apply(7, [](PartitionedMap::partition_type &partition) { return partition.at(7)->second; }).get(), "7+");
+
+	auto failure {hashTable.apply(7, [](PartitionedMap::partition_type &partition) { return partition.at(-7)->second; })};
+	ASSERT_THROW(failure.get(), std::out_of_range);
+}
+
+TEST(hash_table_concurrent, partitioned_map_order_under_back_pressure) {
+	using PartitionedMap = ::containers::hash_table::PartitionedMap<int, int>;
+	//tiny rings, so the producer keeps finding its ring full
+	PartitionedMap hashTable (1, 2);
+	std::vector<int> executed;
+	hashTable.post(0, [](PartitionedMap::partition_type&) { std::this_thread::sleep_for(std::chrono::milliseconds(20)); });
+	int const count {5'000};
+	for (int i {0}; i != count; ++i) {
+		hashTable.post(i, [&executed, i](PartitionedMap::partition_type&) { executed.push_back(i); });
+	}
+	//the worker is done with all the posted ones once this one is
+	hashTable.apply(0, [](PartitionedMap::partition_type&) { return 0; }).get();
+	ASSERT_EQ(executed.size(), static_cast<std::size_t>(count));
+	for (int i {0}; i != count; ++i) {
+		ASSERT_EQ(executed[i], i);
+	}
+}
+
+TEST(hash_table_concurrent, group_by) {
+	struct Stats {
+		long long sum {0};
+		int count {0};
+		std::vector<int> order;
+	};
+	std::vector<int> input (100'000);
+	std::iota(input.begin(), input.end(), 0);
+	auto key = [](int value) { return std::to_string(value % 1'000); };
+	auto combine = [](Stats &stats, int value) {
+		stats.sum += value;
+		++stats.count;
+		if (stats.order.size() < 3) {
+			stats.order.push_back(value);
+		}
+	};
+
+	auto check = [](auto const& grouped) {
+		ASSERT_EQ(grouped.size(), 1'000u);
+		for (int k {0}; k != 1'000; ++k) {
+			Stats const& stats {grouped.at(std::to_string(k))->second};
+			ASSERT_EQ(stats.count, 100);
+			ASSERT_EQ(stats.sum, 100LL * k + 1'000LL * (99 * 100 / 2));
+			//items come to an accumulator in input order
+			ASSERT_EQ(stats.order, (std::vector<int>{k, k + 1'000, k + 2'000}));
+		}
+	};
+	check(::containers::hash_table::group_by<Stats>(input, key, combine, 4));
+
+	std::pmr::synchronized_pool_resource shared;
+	auto const relinked {::containers::hash_table::group_by<Stats>(input, key, combine, 4, &shared)};
+	ASSERT_EQ(relinked.nodeResource(), &shared);
+	check(relinked);
+
+	//one thread, the plain loop
+	check(::containers::hash_table::group_by<Stats>(input, key, combine, 1));
+}
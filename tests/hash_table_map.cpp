@@ -5,9 +5,17 @@
 #include <gtest/gtest.h>
 #include "../include/hash_table.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
+#include <memory_resource>
 #include <fstream>
+#include <numeric>
+#include <ranges>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 TEST(hash_table_map_copy_ctor, EmptyTable) {
 	
@@ -103,6 +111,32 @@ TEST(hash_table_map_copy_ctor, IteratorsAreValid) {
     EXPECT_EQ(count, 3u);
 }
 
+TEST(hash_table_map_copy_ctor, PreservesOrderAfterErase) {
+    ::containers::hash_table::Map<int, std::string> original;
+    for (int i = 0; i != 1'000; ++i) {
+        original.insert(i, std::to_string(i));
+    }
+    for (int i = 0; i < 1'000; i += 4) {
+        original.erase(i);
+    }
+
+    ::containers::hash_table::Map<int, std::string> copy(original);
+
+    EXPECT_EQ(copy.size(), original.size());
+    EXPECT_EQ(copy.capacity(), original.capacity());
+    auto it = copy.cbegin();
+    for (auto const& [k, v] : original) {
+        ASSERT_NE(it, copy.cend());
+        EXPECT_EQ(it->first, k);
+        EXPECT_EQ(it->second, v);
+        EXPECT_NE(&it->second, &v);
+        ++it;
+    }
+    for (int i = 0; i != 1'000; ++i) {
+        EXPECT_EQ(copy.contains(i), i % 4 != 0);
+    }
+}
+
 TEST(hash_table_map_copy_assign, EmptyToEmpty) {
     ::containers::hash_table::Map<int, int> original;
     ::containers::hash_table::Map<int, int> copy;
@@ -241,6 +275,22 @@ TEST(hash_table_map_copy_assign, WithDeletedSlots) {
     EXPECT_TRUE(copy.contains(3));
 }
 
+TEST(hash_table_map_copy_assign, LargeTableWithStrings) {
+    ::containers::hash_table::Map<std::string, int> original;
+    for (int i = 0; i != 10'000; ++i) {
+        original.insert(std::string(32, 'a') + std::to_string(i), i);
+    }
+    ::containers::hash_table::Map<std::string, int> copy;
+    copy.insert("stale", -1);
+    copy = original;
+
+    EXPECT_EQ(copy.size(), 10'000u);
+    EXPECT_FALSE(copy.contains("stale"));
+    for (int i = 0; i != 10'000; ++i) {
+        EXPECT_EQ(copy.find(std::string(32, 'a') + std::to_string(i))->second, i);
+    }
+}
+
 TEST(hash_table_map_copy_assign, ChainedAssignment) {
     ::containers::hash_table::Map<int, int> a;
     a.insert(1, 10);
@@ -407,6 +457,642 @@ TEST(hash_table_map, no_invalidation) {
 	ASSERT_EQ(addressBefore, addressAfter);
 }
 
+TEST(hash_table_map, insert_from_range) {
+	std::vector<std::pair<int, int>> values;
+	for (int i {0}; i != 100'000; ++i) {
+		values.emplace_back(i * 31 % 100'000, i);
+	}
+	values.emplace_back(5, -1);
+	values.emplace_back(6, -1);
+
+	::containers::hash_table::Map<int, int> hashTable;
+	hashTable.insert(7, -7);
+	hashTable.insert(values.begin(), values.end());
+
+	ASSERT_EQ(hashTable.size(), 100'000u);
+	ASSERT_EQ(hashTable.capacity(), 1u << 18);
+	ASSERT_EQ(hashTable.find(7)->second, -7);
+	ASSERT_NE(hashTable.find(5)->second, -1);
+	ASSERT_NE(hashTable.find(6)->second, -1);
+
+	//input order is preserved
+	auto it {hashTable.cbegin()};
+	ASSERT_EQ(it->first, 7);
+	for (auto const& [k, v] : values) {
+		if (k == 7) {
+			continue;
+		}
+		if (v == -1) {
+			break;
+		}
+		++it;
+		ASSERT_EQ(it->first, k);
+		ASSERT_EQ(it->second, v);
+	}
+}
+
+TEST(hash_table_map, range_ctor_and_insert_range) {
+	std::vector<std::pair<int const, int>> values {{1, 10}, {2, 20}, {3, 30}, {1, 100}};
+	::containers::hash_table::Map<int, int> hashTable (values.begin(), values.end());
+	ASSERT_EQ(hashTable.size(), 3u);
+	ASSERT_EQ(hashTable.find(1)->second, 10);
+
+	hashTable.insert_range(values | std::views::transform([](auto const& kv) { return std::pair{kv.first + 3, kv.second}; }));
+	ASSERT_EQ(hashTable.size(), 6u);
+	ASSERT_EQ(hashTable.find(4)->second, 10);
+	ASSERT_EQ(hashTable.find(6)->second, 30);
+
+	hashTable.insert({{7, 70}, {8, 80}});
+	ASSERT_EQ(hashTable.size(), 8u);
+	ASSERT_EQ(hashTable.find(8)->second, 80);
+
+	hashTable.insert(values.begin(), values.begin());
+	ASSERT_EQ(hashTable.size(), 8u);
+}
+
+namespace {
+	struct StringHash {
+		using is_transparent = void;
+		std::size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+	};
+}
+
+TEST(hash_table_map, heterogeneous_lookup) {
+	::containers::hash_table::Map<std::string, int, StringHash, std::equal_to<>> hashTable;
+	for (int i {0}; i != 1'000; ++i) {
+		hashTable.insert(std::to_string(i), i);
+	}
+
+	std::string_view const key {"123"};
+	ASSERT_TRUE(hashTable.contains(key));
+	ASSERT_TRUE(hashTable.contains("999"));
+	ASSERT_FALSE(hashTable.contains(std::string_view{"1000"}));
+	ASSERT_EQ(hashTable.find(key)->second, 123);
+	ASSERT_EQ(std::as_const(hashTable).find("42")->second, 42);
+	ASSERT_EQ(hashTable.at(std::string_view{"7"})->second, 7);
+	ASSERT_THROW(hashTable.at("abc"), std::out_of_range);
+
+	hashTable.find(key)->second = -1;
+	ASSERT_EQ(hashTable.find(std::string{"123"})->second, -1);
+
+	hashTable.erase(key);
+	hashTable.erase("0");
+	ASSERT_EQ(hashTable.size(), 998u);
+	ASSERT_FALSE(hashTable.contains(key));
+	ASSERT_EQ(hashTable.find("0"), hashTable.end());
+
+	hashTable.erase(hashTable.find("1"));
+	ASSERT_EQ(hashTable.size(), 997u);
+}
+
+TEST(hash_table_map, precomputed_hash) {
+	using Table = ::containers::hash_table::Map<std::string, int>;
+	Table first, second;
+	auto const hashFunction {first.hash_function()};
+	for (int i {0}; i != 1'000; ++i) {
+		std::string key {"some_long_enough_key_" + std::to_string(i)};
+		std::size_t const hash {hashFunction(key)};
+		auto [iter, inserted] {first.insert_with_hash({key, i}, hash)};
+		ASSERT_TRUE(inserted);
+		ASSERT_EQ(iter->second, i);
+		ASSERT_FALSE(first.insert_with_hash({key, -i}, hash).second);
+		if (i % 2 == 0) {
+			second.insert_with_hash({key, -i}, hash);
+		}
+	}
+	ASSERT_EQ(first.size(), 1'000u);
+	ASSERT_EQ(second.size(), 500u);
+
+	for (int i {0}; i != 1'000; ++i) {
+		std::string const key {"some_long_enough_key_" + std::to_string(i)};
+		std::size_t const hash {hashFunction(key)};
+		ASSERT_EQ(first.find(key, hash), first.find(key));
+		ASSERT_EQ(first.find(key, hash)->second, i);
+		ASSERT_EQ(second.contains(key, hash), i % 2 == 0);
+		ASSERT_EQ(std::as_const(second).find(key, hash), std::as_const(second).find(key));
+	}
+
+	std::string const key {"some_long_enough_key_10"};
+	first.erase(key, hashFunction(key));
+	ASSERT_EQ(first.size(), 999u);
+	ASSERT_FALSE(first.contains(key));
+	ASSERT_TRUE(first.key_eq()(key, std::string{"some_long_enough_key_10"}));
+
+	auto [iter, inserted] {first.try_emplace_with_hash(key, hashFunction(key), 10)};
+	ASSERT_TRUE(inserted);
+	ASSERT_EQ(iter->second, 10);
+	ASSERT_FALSE(first.try_emplace_with_hash(key, hashFunction(key), -10).second);
+	ASSERT_EQ(first.find(key)->second, 10);
+}
+
+namespace {
+	struct Counted {
+		static inline int constructed {0};
+		static inline int moved {0};
+		int value {0};
+		Counted() { ++constructed; }
+		explicit Counted(int v) : value {v} { ++constructed; }
+		Counted(Counted const& other) : value {other.value} { ++constructed; }
+		Counted(Counted&& other) noexcept : value {other.value} { ++moved; }
+		Counted& operator=(Counted const&) = default;
+		Counted& operator=(Counted&&) noexcept = default;
+		static void reset() { constructed = 0; moved = 0; }
+	};
+}
+
+TEST(hash_table_map, emplace_and_try_emplace) {
+	::containers::hash_table::Map<int, Counted> hashTable;
+	Counted::reset();
+
+	auto [iter, inserted] {hashTable.try_emplace(1, 10)};
+	ASSERT_TRUE(inserted);
+	ASSERT_EQ(iter->second.value, 10);
+	ASSERT_EQ(Counted::constructed, 1);
+	ASSERT_EQ(Counted::moved, 0);
+
+	ASSERT_FALSE(hashTable.try_emplace(1, 20).second);
+	ASSERT_EQ(hashTable.find(1)->second.value, 10);
+	ASSERT_EQ(Counted::constructed, 1);
+
+	ASSERT_TRUE(hashTable.emplace(std::piecewise_construct, std::forward_as_tuple(2), std::forward_as_tuple(20)).second);
+	ASSERT_FALSE(hashTable.emplace(std::piecewise_construct, std::forward_as_tuple(2), std::forward_as_tuple(30)).second);
+	ASSERT_EQ(hashTable.find(2)->second.value, 20);
+	ASSERT_EQ(hashTable.size(), 2u);
+	ASSERT_EQ(Counted::moved, 0);
+
+	Counted::reset();
+	hashTable[1].value += 5;
+	ASSERT_EQ(Counted::constructed, 0);
+	ASSERT_EQ(hashTable[1].value, 15);
+	ASSERT_EQ(hashTable[3].value, 0);
+	ASSERT_EQ(Counted::constructed, 1);
+	ASSERT_EQ(Counted::moved, 0);
+
+	auto [assigned, fresh] {hashTable.insert_or_assign(3, Counted{33})};
+	ASSERT_FALSE(fresh);
+	ASSERT_EQ(assigned->second.value, 33);
+	ASSERT_TRUE(hashTable.insert_or_assign(4, Counted{44}).second);
+	ASSERT_EQ(hashTable.find(4)->second.value, 44);
+	ASSERT_EQ(hashTable.size(), 4u);
+}
+
+TEST(hash_table_map, subscript_counters) {
+	::containers::hash_table::Map<std::string, int> counters;
+	for (int i {0}; i != 10'000; ++i) {
+		counters[std::to_string(i % 100)]++;
+	}
+	ASSERT_EQ(counters.size(), 100u);
+	for (auto const& [key, count] : counters) {
+		ASSERT_EQ(count, 100);
+	}
+	std::string key {"new one"};
+	counters[key] = 5;
+	ASSERT_EQ(counters.find(key)->second, 5);
+	ASSERT_EQ(key, "new one");
+
+	//a duplicate emplace goes away without a trace, the table stays consistent
+	ASSERT_FALSE(counters.emplace(std::string{"7"}, 0).second);
+	ASSERT_FALSE(counters.insert("7", 0).second);
+	ASSERT_EQ(counters.size(), 101u);
+	ASSERT_EQ(counters.find("7")->second, 100);
+	ASSERT_EQ(static_cast<std::size_t>(std::distance(counters.begin(), counters.end())), 101u);
+}
+
+TEST(hash_table_map, extract_and_insert_node) {
+	::containers::hash_table::Map<int, std::string> source, target;
+	for (int i {0}; i != 100; ++i) {
+		source.insert(i, std::to_string(i));
+	}
+	target.insert(7, "seven");
+
+	std::string const* address {&source.find(5)->second};
+	auto node {source.extract(5)};
+	ASSERT_FALSE(node.empty());
+	ASSERT_EQ(node.key(), 5);
+	ASSERT_EQ(&node.mapped(), address);
+	ASSERT_EQ(source.size(), 99u);
+	ASSERT_FALSE(source.contains(5));
+	ASSERT_TRUE(source.extract(5).empty());
+
+	auto [position, inserted, rest] {target.insert(std::move(node))};
+	ASSERT_TRUE(inserted);
+	ASSERT_TRUE(rest.empty());
+	ASSERT_EQ(&position->second, address);
+	ASSERT_EQ(target.find(5)->second, "5");
+
+	auto duplicate {target.insert(source.extract(source.find(7)))};
+	ASSERT_FALSE(duplicate.inserted);
+	ASSERT_EQ(duplicate.position->second, "seven");
+	ASSERT_EQ(duplicate.node.mapped(), "7");
+	ASSERT_EQ(source.size(), 98u);
+	ASSERT_EQ(target.size(), 2u);
+
+	ASSERT_FALSE(target.insert(decltype(target)::node_type{}).inserted);
+}
+
+TEST(hash_table_map, merge) {
+	::containers::hash_table::Map<int, std::string> source, target;
+	for (int i {0}; i != 1'000; ++i) {
+		source.insert(i, std::to_string(i));
+	}
+	for (int i {0}; i != 1'000; i += 10) {
+		target.insert(i, "target");
+	}
+	std::string const* address {&source.find(11)->second};
+
+	target.merge(source);
+	ASSERT_EQ(target.size(), 1'000u);
+	ASSERT_EQ(source.size(), 100u);
+	ASSERT_EQ(&target.find(11)->second, address);
+	for (int i {0}; i != 1'000; ++i) {
+		ASSERT_EQ(target.find(i)->second, i % 10 == 0 ? "target" : std::to_string(i));
+		ASSERT_EQ(source.contains(i), i % 10 == 0);
+	}
+
+	std::pmr::unsynchronized_pool_resource pool;
+	::containers::hash_table::Map<int, std::string> other (0, &pool);
+	other.insert(5'000, "moved");
+	target.merge(std::move(other));
+	ASSERT_EQ(target.find(5'000)->second, "moved");
+	ASSERT_TRUE(other.empty());
+}
+
+TEST(hash_table_map, partitions) {
+	containers::hash_table::Map<int, int> hashTable;
+	for (int i {0}; i != 10'000; ++i) {
+		hashTable.insert(i, i);
+	}
+	auto const parts {hashTable.partitions(7)};
+	ASSERT_EQ(parts.size(), 7u);
+	std::vector<int> seen (10'000, 0);
+	for (auto const& part : parts) {
+		for (auto const& [key, value] : part) {
+			++seen[key];
+		}
+	}
+	ASSERT_TRUE(std::ranges::all_of(seen, [](int count) { return count == 1; }));
+
+	//updated in place, each element once
+	hashTable.parallel_for_each([](auto &kv) { kv.second *= 2; }, 4);
+	std::atomic<long long> sum {0};
+	std::as_const(hashTable).parallel_for_each([&sum](auto const& kv) { sum += kv.second; }, 4);
+	ASSERT_EQ(sum, 2LL * 9'999 * 10'000 / 2);
+
+	//equal keys are never split between the parts
+	containers::hash_table::MultiMap<int, int> multi;
+	for (int i {0}; i != 3'000; ++i) {
+		multi.insert(i % 100, i);
+	}
+	std::size_t total {0};
+	for (auto const& part : multi.partitions(16)) {
+		std::vector<int> keys;
+		for (auto const& kv : part) {
+			keys.push_back(kv.first);
+			++total;
+		}
+		for (int key : keys) {
+			ASSERT_EQ(std::ranges::count(keys, key), 30);
+		}
+	}
+	ASSERT_EQ(total, 3'000u);
+}
+
+TEST(hash_table_map, bulk_erase) {
+	::containers::hash_table::Map<int, std::string> hashTable;
+	for (int i {0}; i != 1'000; ++i) {
+		hashTable.insert(i, std::to_string(i));
+	}
+
+	std::size_t const erased {erase_if(hashTable, [](auto const& kv) { return kv.first % 3 == 0; })};
+	ASSERT_EQ(erased, 334u);
+	ASSERT_EQ(hashTable.size(), 666u);
+	ASSERT_FALSE(hashTable.contains(3));
+	ASSERT_TRUE(hashTable.contains(4));
+
+	std::vector<int> keys {1, 2, 3, 4, 5, 1, 2'000};
+	ASSERT_EQ(hashTable.erase_many(keys), 4u);
+	ASSERT_EQ(hashTable.size(), 662u);
+
+	//insertion order is kept, so the range is [7, 500)
+	auto first {hashTable.find(7)};
+	auto last {hashTable.find(500)};
+	auto next {hashTable.erase(first, last)};
+	ASSERT_EQ(next, hashTable.find(500));
+	ASSERT_EQ(hashTable.begin()->first, 500);
+	ASSERT_EQ(hashTable.size(), 333u);
+	for (int i {0}; i != 1'000; ++i) {
+		ASSERT_EQ(hashTable.contains(i), i >= 500 && i % 3 != 0);
+	}
+	ASSERT_EQ(hashTable.erase(hashTable.end(), hashTable.end()), hashTable.end());
+	hashTable.erase(hashTable.find(2'000));
+	ASSERT_EQ(hashTable.size(), 333u);
+
+	hashTable.insert(7, "7");
+	ASSERT_EQ(hashTable.find(7)->second, "7");
+}
+
+TEST(hash_table_map, insert_unique_unchecked) {
+	::containers::hash_table::Map<int, int> hashTable;
+	for (int i {0}; i != 1'000; ++i) {
+		auto iter {hashTable.insert_unique_unchecked({i, i * 2})};
+		ASSERT_EQ(iter->first, i);
+	}
+	std::vector<std::pair<int const, int>> snapshot;
+	for (int i {1'000}; i != 50'000; ++i) {
+		snapshot.emplace_back(i, i * 2);
+	}
+	hashTable.insert_unique_unchecked(snapshot.begin(), snapshot.end());
+	ASSERT_EQ(hashTable.size(), 50'000u);
+	for (int i {0}; i != 50'000; ++i) {
+		ASSERT_EQ(hashTable.find(i)->second, i * 2);
+	}
+	ASSERT_EQ(hashTable.begin()->first, 0);
+	ASSERT_EQ(hashTable.rbegin()->first, 49'999);
+
+	hashTable.erase(7);
+	ASSERT_FALSE(hashTable.insert(8, 0).second);
+	ASSERT_TRUE(hashTable.insert(7, 0).second);
+	EXPECT_DEBUG_DEATH(hashTable.insert_unique_unchecked({42, 0}), "duplicate");
+}
+
+TEST(hash_table_map, find_many) {
+	::containers::hash_table::Map<int, int> hashTable;
+	for (int i {0}; i < 10'000; i += 2) {
+		hashTable.insert(i, i * 10);
+	}
+	std::vector<int> keys;
+	for (int i {0}; i != 100; ++i) {
+		keys.push_back(i * 97 % 10'000);
+	}
+	std::vector<::containers::hash_table::Map<int, int>::const_iterator> found (keys.size());
+	hashTable.find_many(keys, found);
+	for (std::size_t i {0}; i != keys.size(); ++i) {
+		ASSERT_EQ(found[i], std::as_const(hashTable).find(keys[i]));
+		if (keys[i] % 2 == 0) {
+			ASSERT_EQ(found[i]->second, keys[i] * 10);
+		}
+		else {
+			ASSERT_EQ(found[i], hashTable.cend());
+		}
+	}
+
+	std::vector<::containers::hash_table::Map<int, int>::const_iterator> tooShort (keys.size() - 1);
+	ASSERT_THROW(hashTable.find_many(keys, tooShort), std::invalid_argument);
+}
+
+TEST(hash_table_map, contains_many) {
+	::containers::hash_table::Map<int, int> hashTable;
+	for (int i {0}; i < 64; i += 3) {
+		hashTable.insert(i, i);
+	}
+	std::array<int, 64> keys;
+	std::iota(keys.begin(), keys.end(), 0);
+	std::uint64_t const mask {hashTable.contains_many(keys)};
+	for (int i {0}; i != 64; ++i) {
+		ASSERT_EQ(((mask >> i) & 1u) == 1u, i % 3 == 0);
+	}
+	ASSERT_EQ(hashTable.contains_many({}), 0u);
+
+	std::vector<int> tooMany (65);
+	ASSERT_THROW(hashTable.contains_many(tooMany), std::invalid_argument);
+}
+
+TEST(hash_table_map, clear) {
+	::containers::hash_table::Map<int, int> hashTable;
+	for (int i {0}; i != 1'000; ++i) {
+		hashTable.insert(i, i);
+	}
+	std::size_t const cap {hashTable.capacity()};
+	std::pair<int const, int> const* oldAddress {&*hashTable.find(0)};
+
+	hashTable.clear();
+	ASSERT_TRUE(hashTable.empty());
+	ASSERT_EQ(hashTable.capacity(), cap);
+	ASSERT_EQ(hashTable.begin(), hashTable.end());
+	for (int i {0}; i != 1'000; ++i) {
+		ASSERT_FALSE(hashTable.contains(i));
+	}
+
+	//trivially destructible values reuse the nodes
+	auto [it, ok] {hashTable.insert(42, 42)};
+	ASSERT_TRUE(ok);
+	ASSERT_EQ(&*it, oldAddress);
+	for (int i {0}; i != 1'000; ++i) {
+		hashTable.insert(i, -i);
+	}
+	ASSERT_EQ(hashTable.size(), 1'000u);
+	for (int i {0}; i != 1'000; ++i) {
+		ASSERT_EQ(hashTable.find(i)->second, i == 42 ? 42 : -i);
+	}
+}
+
+TEST(hash_table_map, clear_destroys_values) {
+	auto counter {std::make_shared<int>(0)};
+	::containers::hash_table::Map<int, std::shared_ptr<int>> hashTable;
+	for (int i {0}; i != 100; ++i) {
+		hashTable.insert(i, counter);
+	}
+	hashTable.erase(0);
+	ASSERT_GT(counter.use_count(), 1);
+	hashTable.clear();
+	ASSERT_EQ(counter.use_count(), 1);
+	ASSERT_TRUE(hashTable.empty());
+	hashTable.insert(1, counter);
+	ASSERT_EQ(hashTable.size(), 1u);
+}
+
+TEST(hash_table_map, moved_from_is_usable) {
+	::containers::hash_table::Map<int, int> source;
+	for (int i {0}; i != 100; ++i) {
+		source.insert(i, i);
+	}
+	::containers::hash_table::Map<int, int> target {std::move(source)};
+	ASSERT_EQ(target.size(), 100u);
+
+	source.insert(1, 1);
+	ASSERT_EQ(source.size(), 1u);
+	ASSERT_TRUE(source.contains(1));
+
+	target = std::move(source);
+	ASSERT_EQ(target.size(), 1u);
+	ASSERT_TRUE(source.empty());
+	source.insert(2, 2);
+	ASSERT_TRUE(source.contains(2));
+}
+
+TEST(hash_table_map, compact) {
+	::containers::hash_table::Map<int, int> hashTable;
+	for (int i {0}; i != 1'000; ++i) {
+		hashTable.insert(i, i * 10);
+	}
+	for (int i {0}; i < 1'000; i += 3) {
+		hashTable.erase(i);
+	}
+	std::vector<int> keysBefore;
+	for (auto const& [k, v] : hashTable) {
+		keysBefore.push_back(k);
+	}
+	std::size_t const epochBefore {hashTable.epoch()};
+
+	std::size_t relocated {0};
+	hashTable.compact([&relocated](auto const* from, auto const* to) {
+		ASSERT_NE(from, to);
+		ASSERT_EQ(from->first, to->first);
+		++relocated;
+	});
+
+	ASSERT_EQ(relocated, hashTable.size());
+	ASSERT_EQ(hashTable.epoch(), epochBefore + 1);
+
+	std::vector<int> keysAfter;
+	for (auto const& [k, v] : hashTable) {
+		keysAfter.push_back(k);
+		ASSERT_EQ(v, k * 10);
+	}
+	ASSERT_EQ(keysBefore, keysAfter);
+
+	for (int i {0}; i != 1'000; ++i) {
+		ASSERT_EQ(hashTable.contains(i), i % 3 != 0);
+	}
+	hashTable.insert(0, 0);
+	ASSERT_TRUE(hashTable.contains(0));
+}
+
+TEST(hash_table_map, compact_relocation_addresses) {
+	::containers::hash_table::Map<int, int> hashTable;
+	for (int i {0}; i != 100; ++i) {
+		hashTable.insert(i, i);
+	}
+	std::vector<std::pair<int const, int> const*> external;
+	for (int i {0}; i != 100; ++i) {
+		external.push_back(&*hashTable.find(i));
+	}
+
+	hashTable.compact([&external](auto const* from, auto const* to) {
+		for (auto& ptr : external) {
+			if (ptr == from) { ptr = to; }
+		}
+	});
+
+	for (int i {0}; i != 100; ++i) {
+		ASSERT_EQ(external[i], &*hashTable.find(i));
+		ASSERT_EQ(external[i]->second, i);
+	}
+}
+
+namespace {
+	//gives up after a number of allocations
+	struct LimitedResource final : std::pmr::memory_resource {
+		std::size_t left;
+		explicit LimitedResource(std::size_t allocations) : left {allocations} {}
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+			if (left == 0) {
+				throw std::bad_alloc();
+			}
+			--left;
+			return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+		}
+		void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+			std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+		}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+	};
+}
+
+TEST(hash_table_map, merge_exception_safety) {
+	//nodes are moved one by one between different resources, the target runs out of them half way
+	::containers::hash_table::Map<int, std::string> source;
+	for (int i {0}; i != 100; ++i) {
+		source.insert(i, std::to_string(i));
+	}
+	LimitedResource nodes {50};
+	::containers::hash_table::Map<int, std::string> target (0, &nodes);
+	ASSERT_THROW(target.merge(source), std::bad_alloc);
+	ASSERT_EQ(target.size(), 50u);
+	ASSERT_EQ(source.size(), 50u);
+	for (int i {0}; i != 100; ++i) {
+		auto const& holder {target.contains(i) ? target : source};
+		ASSERT_NE(target.contains(i), source.contains(i));
+		ASSERT_EQ(holder.at(i)->second, std::to_string(i));
+	}
+	ASSERT_EQ(static_cast<std::size_t>(std::distance(source.begin(), source.end())), source.size());
+}
+
+TEST(hash_table_map, compact_exception_safety) {
+	//nodes run out half way, the elements moved so far are moved back
+	LimitedResource nodes {150};
+	::containers::hash_table::Map<int, std::string> hashTable (0, &nodes);
+	for (int i {0}; i != 100; ++i) {
+		hashTable.insert(i, "value_long_enough_to_be_on_heap_" + std::to_string(i));
+	}
+	std::size_t const epochBefore {hashTable.epoch()};
+	ASSERT_THROW(hashTable.compact(), std::bad_alloc);
+	ASSERT_EQ(hashTable.epoch(), epochBefore);
+	ASSERT_EQ(hashTable.size(), 100u);
+	for (int i {0}; i != 100; ++i) {
+		ASSERT_EQ(hashTable.at(i)->second, "value_long_enough_to_be_on_heap_" + std::to_string(i));
+	}
+
+	//relocate is called on the compacted table, a throw stops the reports only
+	nodes.left = 1'000;
+	int reported {0};
+	auto failing = [&reported](auto const*, auto const*) {
+		if (++reported == 10) {
+			throw std::runtime_error("relocate");
+		}
+	};
+	ASSERT_THROW(hashTable.compact(failing), std::runtime_error);
+	ASSERT_EQ(hashTable.epoch(), epochBefore + 1);
+	ASSERT_EQ(hashTable.size(), 100u);
+	for (int i {0}; i != 100; ++i) {
+		ASSERT_EQ(hashTable.at(i)->second, "value_long_enough_to_be_on_heap_" + std::to_string(i));
+	}
+}
+
+TEST(hash_table_map, merge_unique_unchecked) {
+	//enough elements for the index to be built on several threads
+	using Table = ::containers::hash_table::Map<int, std::string>;
+	std::pmr::unsynchronized_pool_resource pool;
+	Table target;
+	std::vector<Table> partials;
+	partials.emplace_back();
+	partials.emplace_back(0, &pool);
+	for (int i {0}; i != 1'000; ++i) {
+		target.insert(i, "target");
+	}
+	for (int i {1'000}; i != 80'000; ++i) {
+		partials[i % 2].insert(i, std::to_string(i));
+	}
+	std::string const* relinked {&partials[0].find(1'000)->second};
+
+	target.merge_unique_unchecked(partials, 4);
+	ASSERT_EQ(target.size(), 80'000u);
+	ASSERT_TRUE(partials[0].empty());
+	ASSERT_TRUE(partials[1].empty());
+	ASSERT_EQ(&target.find(1'000)->second, relinked);
+	for (int i {0}; i != 80'000; ++i) {
+		ASSERT_EQ(target.at(i)->second, i < 1'000 ? "target" : std::to_string(i));
+	}
+	ASSERT_EQ(static_cast<std::size_t>(std::distance(target.begin(), target.end())), target.size());
+
+	//nodes run out half way, the values moved so far go back
+	LimitedResource nodes {50};
+	Table limited (0, &nodes);
+	std::vector<Table> sources (1);
+	for (int i {0}; i != 100; ++i) {
+		sources[0].insert(i, "value_long_enough_to_be_on_heap_" + std::to_string(i));
+	}
+	ASSERT_THROW(limited.merge_unique_unchecked(sources, 4), std::bad_alloc);
+	ASSERT_TRUE(limited.empty());
+	ASSERT_EQ(sources[0].size(), 100u);
+	for (int i {0}; i != 100; ++i) {
+		ASSERT_EQ(sources[0].at(i)->second, "value_long_enough_to_be_on_heap_" + std::to_string(i));
+	}
+}
+
 
 
 
@@ -0,0 +1,118 @@
+//
+// Multi keys variants of the hash table
+//
+
+#include <gtest/gtest.h>
+#include "../include/hash_table.hpp"
+
+#include <string>
+#include <vector>
+
+TEST(hash_table_multi, multimap_equal_range) {
+	::containers::hash_table::MultiMap<int, std::string> hashTable;
+	hashTable.insert(1, "a");
+	hashTable.insert(2, "b");
+	hashTable.insert(1, "c");
+	hashTable.emplace(3, "d");
+	hashTable.insert(std::pair<int const, std::string>{1, "e"});
+	ASSERT_EQ(hashTable.size(), 5u);
+	ASSERT_EQ(hashTable.count(1), 3u);
+	ASSERT_EQ(hashTable.count(2), 1u);
+	ASSERT_EQ(hashTable.count(4), 0u);
+
+	//equal keys are adjacent and keep insertion order
+	auto [first, last] {hashTable.equal_range(1)};
+	std::vector<std::string> values;
+	for (; first != last; ++first) {
+		ASSERT_EQ(first->first, 1);
+		values.push_back(first->second);
+	}
+	ASSERT_EQ(values, (std::vector<std::string>{"a", "c", "e"}));
+	ASSERT_EQ(hashTable.find(1)->second, "a");
+
+	auto [none, noneEnd] {std::as_const(hashTable).equal_range(4)};
+	ASSERT_EQ(none, noneEnd);
+	ASSERT_EQ(none, hashTable.cend());
+}
+
+TEST(hash_table_multi, multimap_pointer_stability) {
+	::containers::hash_table::MultiMap<int, int> hashTable;
+	std::vector<int const*> addresses;
+	for (int i {0}; i != 10'000; ++i) {
+		auto [iter, inserted] {hashTable.insert(i % 100, i)};
+		ASSERT_TRUE(inserted);
+		addresses.push_back(&iter->second);
+	}
+	ASSERT_EQ(hashTable.size(), 10'000u);
+	for (int i {0}; i != 10'000; ++i) {
+		ASSERT_EQ(*addresses[i], i);
+	}
+	for (int key {0}; key != 100; ++key) {
+		auto [first, last] {hashTable.equal_range(key)};
+		int expected {key};
+		for (; first != last; ++first, expected += 100) {
+			ASSERT_EQ(first->second, expected);
+		}
+		ASSERT_EQ(expected, key + 10'000);
+	}
+
+	//erasing single elements — first of a group, one in the middle, the last one
+	hashTable.erase(hashTable.find(5));
+	auto [first, last] {hashTable.equal_range(5)};
+	ASSERT_EQ(first->second, 105);
+	hashTable.erase(std::next(first, 10));
+	hashTable.erase(std::prev(last));
+	ASSERT_EQ(hashTable.count(5), 97u);
+	ASSERT_EQ(hashTable.find(5)->second, 105);
+	ASSERT_EQ(*addresses[205], 205);
+
+	hashTable.erase(7);
+	ASSERT_FALSE(hashTable.contains(7));
+	ASSERT_EQ(hashTable.size(), 10'000u - 3u - 100u);
+	ASSERT_EQ(*addresses[8], 8);
+
+	std::size_t const erased {erase_if(hashTable, [](auto const& kv) { return kv.second % 2 == 0; })};
+	ASSERT_EQ(erased, 5'000u);
+	ASSERT_EQ(hashTable.size(), 10'000u - 3u - 100u - 5'000u);
+	ASSERT_EQ(hashTable.count(4), 0u);
+	ASSERT_EQ(hashTable.count(3), 100u);
+	ASSERT_EQ(hashTable.find(5)->second, 105);
+}
+
+TEST(hash_table_multi, multimap_copy_and_merge) {
+	::containers::hash_table::MultiMap<int, int> source;
+	for (int i {0}; i != 1'000; ++i) {
+		source.insert(i % 10, i);
+	}
+	::containers::hash_table::MultiMap<int, int> copy (source);
+	ASSERT_EQ(copy.size(), 1'000u);
+	ASSERT_EQ(copy.count(3), 100u);
+
+	::containers::hash_table::MultiMap<int, int> target;
+	target.insert(3, -1);
+	target.merge(copy);
+	ASSERT_TRUE(copy.empty());
+	ASSERT_EQ(target.size(), 1'001u);
+	auto [first, last] {target.equal_range(3)};
+	ASSERT_EQ(first->second, -1);
+	ASSERT_EQ(std::distance(first, last), 101);
+	ASSERT_EQ(std::next(first)->second, 3);
+}
+
+TEST(hash_table_multi, multiset) {
+	::containers::hash_table::MultiSet<std::string> hashTable;
+	std::vector<std::string> words {"a", "b", "a", "c", "b", "a"};
+	hashTable.insert(words.begin(), words.end());
+	ASSERT_EQ(hashTable.size(), 6u);
+	ASSERT_EQ(hashTable.count("a"), 3u);
+	ASSERT_EQ(hashTable.count("b"), 2u);
+
+	std::vector<std::string> ordered (hashTable.begin(), hashTable.end());
+	ASSERT_EQ(ordered, (std::vector<std::string>{"a", "a", "a", "b", "b", "c"}));
+
+	hashTable.erase(std::string{"a"});
+	ASSERT_EQ(hashTable.size(), 3u);
+	ASSERT_FALSE(hashTable.contains("a"));
+	hashTable.insert(std::string{"c"});
+	ASSERT_EQ(hashTable.count("c"), 2u);
+}
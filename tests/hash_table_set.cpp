@@ -5,6 +5,13 @@
 #include <gtest/gtest.h>
 #include "../include/hash_table.hpp"
 
+#include <cstdint>
+#include <numeric>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <vector>
+
 TEST(hash_table_set_copy_ctor, SetVariant) {
     ::containers::hash_table::Set<int> original;
     original.insert(1);
@@ -182,6 +189,168 @@ TEST(hash_table_set, no_invalidation) {
 	ASSERT_EQ(addressBefore, addressAfter);
 }
 
+TEST(hash_table_set, insert_from_range) {
+	::containers::hash_table::Set<int> hashTable (std::views::iota(0, 10'000).begin(), std::views::iota(0, 10'000).end());
+	ASSERT_EQ(hashTable.size(), 10'000u);
+	for (int i {0}; i != 10'000; ++i) {
+		ASSERT_TRUE(hashTable.contains(i));
+	}
+	for (int i {0}; i < 10'000; i += 2) {
+		hashTable.erase(i);
+	}
+	hashTable.insert_range(std::views::iota(5'000, 20'000));
+	ASSERT_EQ(hashTable.size(), 2'500u + 15'000u);
+	for (int i {0}; i != 20'000; ++i) {
+		ASSERT_EQ(hashTable.contains(i), i >= 5'000 || i % 2 != 0);
+	}
+
+	//single pass input
+	std::istringstream input {"42 43 42 44"};
+	::containers::hash_table::Set<int> fromStream (std::istream_iterator<int>{input}, std::istream_iterator<int>{});
+	ASSERT_EQ(fromStream.size(), 3u);
+	std::vector<int> order (fromStream.begin(), fromStream.end());
+	ASSERT_EQ(order, (std::vector<int>{42, 43, 44}));
+
+	//duplicates don't leave the index oversized
+	std::vector<int> repeated (100'000);
+	for (std::size_t i {0}; i != repeated.size(); ++i) {
+		repeated[i] = static_cast<int>(i % 10);
+	}
+	::containers::hash_table::Set<int> fewKeys;
+	std::size_t const capacityBefore {fewKeys.capacity()};
+	fewKeys.insert(repeated.begin(), repeated.end());
+	ASSERT_EQ(fewKeys.size(), 10u);
+	ASSERT_EQ(fewKeys.capacity(), capacityBefore);
+	for (int i {0}; i != 10; ++i) {
+		ASSERT_TRUE(fewKeys.contains(i));
+	}
+}
+
+TEST(hash_table_set, find_many) {
+	::containers::hash_table::Set<int> hashTable;
+	for (int i {0}; i != 1'000; ++i) {
+		hashTable.insert(i * 7);
+	}
+	for (int i {0}; i < 1'000; i += 14) {
+		hashTable.erase(i);
+	}
+	std::vector<int> keys (1'000);
+	std::iota(keys.begin(), keys.end(), 0);
+	std::vector<::containers::hash_table::Set<int>::const_iterator> found (keys.size());
+	hashTable.find_many(keys, found);
+	for (int key : keys) {
+		ASSERT_EQ(found[key], hashTable.find(key));
+		ASSERT_EQ(found[key] != hashTable.end(), key % 7 == 0 && key % 14 != 0);
+	}
+}
+
+TEST(hash_table_set, merge) {
+	::containers::hash_table::Set<int> source, target;
+	for (int i {0}; i != 100; ++i) {
+		source.insert(i);
+	}
+	for (int i {50}; i != 150; ++i) {
+		target.insert(i);
+	}
+	int const* address {&*source.find(10)};
+	target.merge(source);
+	ASSERT_EQ(target.size(), 150u);
+	ASSERT_EQ(source.size(), 50u);
+	ASSERT_EQ(&*target.find(10), address);
+	ASSERT_TRUE(source.contains(50));
+	ASSERT_FALSE(source.contains(49));
+
+	auto node {target.extract(120)};
+	ASSERT_EQ(node.value(), 120);
+	node.value() = 1'000;
+	ASSERT_TRUE(target.insert(std::move(node)).inserted);
+	ASSERT_TRUE(target.contains(1'000));
+	ASSERT_FALSE(target.contains(120));
+}
+
+TEST(hash_table_set, build_parallel) {
+	//with duplicates, and some keys in the table already
+	std::vector<std::string> input;
+	for (int i {0}; i != 100'000; ++i) {
+		input.push_back(std::to_string(i % 60'000));
+	}
+	containers::hash_table::Set<std::string> parallel, sequential;
+	for (int i {59'990}; i != 60'010; ++i) {
+		parallel.insert(std::to_string(i));
+		sequential.insert(std::to_string(i));
+	}
+	//and tombstones, the nodes are placed around those
+	parallel.setDeferredMaintenance(true);
+	for (int i {70'000}; i != 70'010; ++i) {
+		parallel.insert(std::to_string(i));
+		parallel.erase(std::to_string(i));
+	}
+	parallel.build_parallel(input.begin(), input.end(), 4);
+	sequential.insert(input.begin(), input.end());
+
+	ASSERT_EQ(parallel.size(), 60'010u);
+	ASSERT_EQ(parallel.capacity(), sequential.capacity());
+	ASSERT_TRUE(std::ranges::equal(parallel, sequential));
+	for (std::string const& key : input) {
+		ASSERT_TRUE(parallel.contains(key));
+	}
+	ASSERT_FALSE(parallel.contains("60010"));
+
+	//a small one goes the usual way
+	containers::hash_table::Set<int> small;
+	std::vector<int> const values {3, 1, 3, 2};
+	small.build_parallel(values.begin(), values.end(), 4);
+	ASSERT_EQ(small.size(), 3u);
+}
+
+TEST(hash_table_set, compact) {
+	::containers::hash_table::Set<int> hashTable;
+	for (int i {0}; i != 1'000; ++i) {
+		hashTable.insert(i);
+	}
+	for (int i {0}; i < 1'000; i += 2) {
+		hashTable.erase(i);
+	}
+	std::size_t const epochBefore {hashTable.epoch()};
+	hashTable.compact();
+	ASSERT_EQ(hashTable.epoch(), epochBefore + 1);
+	ASSERT_EQ(hashTable.size(), 500u);
+
+	int expected {1};
+	for (int elem : hashTable) {
+		ASSERT_EQ(elem, expected);
+		expected += 2;
+	}
+	for (int i {0}; i != 1'000; ++i) {
+		ASSERT_EQ(hashTable.contains(i), i % 2 != 0);
+	}
+
+	//the holes of the erased nodes are not reused, nodes follow iteration order one after another,
+	//the only gaps are where a pool chunk ends
+	::containers::hash_table::Set<std::string> strings;
+	for (int i {0}; i != 2'000; ++i) {
+		strings.insert(std::to_string(i));
+	}
+	for (int i {0}; i < 2'000; i += 2) {
+		strings.erase(std::to_string(i));
+	}
+	//erased nodes are given back to the pool
+	strings.rehash(0);
+	strings.compact();
+	std::vector<std::uintptr_t> addresses;
+	for (std::string const& elem : strings) {
+		addresses.push_back(reinterpret_cast<std::uintptr_t>(&elem));
+	}
+	ASSERT_LT(addresses[0], addresses[1]);
+	std::size_t const stride {addresses[1] - addresses[0]};
+	std::size_t gaps {0};
+	for (std::size_t i {1}; i != addresses.size(); ++i) {
+		gaps += addresses[i] - addresses[i - 1] != stride;
+	}
+	std::size_t const chunkSize {::containers::pmr::PoolResource::defaultChunkSize};
+	ASSERT_LE(gaps, addresses.size() * stride / chunkSize + 1);
+}
+
 TEST(hash_table_set, hash_values_collision1) {
 	::containers::hash_table::Set<int> hashTable;
 	hashTable.insert(799); //with initial capacity 20 h == 19
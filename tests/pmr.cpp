@@ -92,3 +92,314 @@ TEST(hash_table_pmr, move_assignment) {
 	same = first_copy.l.get_allocator().resource()->is_equal(*second.l.get_allocator().resource());
 	ASSERT_TRUE(same);
 }
+
+TEST(hash_table_pmr, custom_resources) {
+	std::pmr::unsynchronized_pool_resource nodes;
+	std::pmr::monotonic_buffer_resource index;
+	::containers::hash_table::Map<int, int> hashTable (64, &nodes, &index);
+	ASSERT_EQ(hashTable.nodeResource(), &nodes);
+	ASSERT_EQ(hashTable.indexResource(), &index);
+
+	for (int i {0}; i != 10'000; ++i) {
+		hashTable.insert(i, i);
+	}
+	for (int i {0}; i != 10'000; ++i) {
+		ASSERT_EQ(hashTable.find(i)->second, i);
+	}
+
+	::containers::hash_table::Map<int, int> copy (hashTable);
+	ASSERT_EQ(copy.nodeResource(), &nodes);
+	ASSERT_EQ(copy.indexResource(), &index);
+	ASSERT_EQ(copy.size(), hashTable.size());
+}
+
+TEST(hash_table_pmr, move_assignment_between_resources) {
+	std::pmr::unsynchronized_pool_resource nodes;
+	::containers::hash_table::Map<int, int> source (0, &nodes);
+	for (int i {0}; i != 1'000; ++i) {
+		source.insert(i, i * 2);
+	}
+
+	::containers::hash_table::Map<int, int> target;
+	target.insert(-1, -1);
+	target = std::move(source);
+
+	ASSERT_EQ(target.size(), 1'000u);
+	ASSERT_FALSE(target.contains(-1));
+	for (int i {0}; i != 1'000; ++i) {
+		ASSERT_EQ(target.find(i)->second, i * 2);
+	}
+
+	//nodes are allocated on the target's resource, a failure gets to the caller
+	::containers::hash_table::Map<int, int> noMemory (0, std::pmr::null_memory_resource());
+	ASSERT_THROW(noMemory = std::move(target), std::bad_alloc);
+	ASSERT_TRUE(noMemory.empty());
+}
+
+#if defined(__linux__)
+TEST(hash_table_pmr, huge_page_resource) {
+	::containers::pmr::HugePageMemoryResource hugePages;
+	std::size_t const big {::containers::pmr::HugePageMemoryResource::hugePageSize * 2 + 42};
+
+	void* p {hugePages.allocate(big, 64)};
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p) % ::containers::pmr::HugePageMemoryResource::hugePageSize, 0u);
+	static_cast<char*>(p)[big - 1] = 42;
+	hugePages.deallocate(p, big, 64);
+
+	void* small {hugePages.allocate(100, 4096 * 4)};
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(small) % (4096 * 4), 0u);
+	hugePages.deallocate(small, 100, 4096 * 4);
+
+	ASSERT_TRUE(hugePages.is_equal(hugePages));
+	::containers::pmr::HugePageMemoryResource other;
+	ASSERT_FALSE(hugePages.is_equal(other));
+}
+
+TEST(hash_table_pmr, huge_page_resource_for_index_and_nodes) {
+	::containers::pmr::HugePageMemoryResource hugePages {true};
+	ASSERT_TRUE(hugePages.prefaults());
+	std::pmr::unsynchronized_pool_resource nodes {&hugePages};
+
+	::containers::hash_table::Set<int> hashTable (1 << 18, &nodes, &hugePages);
+	for (int i {0}; i != 100'000; ++i) {
+		hashTable.insert(i);
+	}
+	for (int i {0}; i != 100'000; ++i) {
+		ASSERT_TRUE(hashTable.contains(i));
+	}
+	for (int i {0}; i != 100'000; i += 2) {
+		hashTable.erase(i);
+	}
+	ASSERT_EQ(hashTable.size(), 50'000u);
+	ASSERT_TRUE(hashTable.contains(99'999));
+}
+#endif
+
+struct CountingResource final : std::pmr::memory_resource {
+	std::size_t allocations {0};
+	std::size_t deallocations {0};
+	std::size_t bytesInUse {0};
+	std::size_t maxAlignment {0};
+
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+		++allocations;
+		bytesInUse += bytes;
+		maxAlignment = std::max(maxAlignment, alignment);
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+	void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+		++deallocations;
+		bytesInUse -= bytes;
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+};
+
+TEST(hash_table_pmr, pool_resource_trim) {
+	CountingResource upstream;
+	{
+		::containers::pmr::PoolResource pool {&upstream, 1 << 12};
+		std::vector<void*> blocks;
+		for (int i {0}; i != 10'000; ++i) {
+			void* p {pool.allocate(24, 8)};
+			ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p) % 8, 0u);
+			blocks.push_back(p);
+		}
+		std::size_t const chunksPeak {pool.chunks()};
+		ASSERT_GT(chunksPeak, 1u);
+		ASSERT_EQ(upstream.bytesInUse, pool.bytesHeld());
+		ASSERT_EQ(pool.trim(), 0u);
+
+		//first half of the blocks fill the first chunks, those get empty
+		for (std::size_t i {0}; i != blocks.size() / 2; ++i) {
+			pool.deallocate(blocks[i], 24, 8);
+		}
+		std::size_t const released {pool.trim()};
+		ASSERT_GT(released, 0u);
+		ASSERT_LT(pool.chunks(), chunksPeak);
+		ASSERT_EQ(upstream.bytesInUse, pool.bytesHeld());
+
+		//the rest is intact and reusable
+		for (std::size_t i {blocks.size() / 2}; i != blocks.size(); ++i) {
+			*static_cast<int*>(blocks[i]) = 42;
+			pool.deallocate(blocks[i], 24, 8);
+		}
+		pool.trim();
+		ASSERT_EQ(pool.chunks(), 0u);
+		ASSERT_EQ(upstream.bytesInUse, 0u);
+
+		void* big {pool.allocate(1 << 12, 8)};
+		ASSERT_EQ(pool.chunks(), 0u);
+		pool.deallocate(big, 1 << 12, 8);
+
+		void* p {pool.allocate(100, 64)};
+		ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p) % 64, 0u);
+	}
+	ASSERT_EQ(upstream.bytesInUse, 0u);
+	ASSERT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST(hash_table_pmr, pool_resource_alignment) {
+	CountingResource upstream;
+	{
+		//chunks are naturally aligned, unless a request asks for more
+		::containers::pmr::PoolResource pool {&upstream, 1 << 12};
+		std::vector<void*> blocks;
+		for (int i {0}; i != 1'000; ++i) {
+			blocks.push_back(pool.allocate(64, 8));
+		}
+		ASSERT_EQ(upstream.maxAlignment, alignof(std::max_align_t));
+		for (int i {0}; i != 1'000; ++i) {
+			void* p {pool.allocate(64, 64)};
+			ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p) % 64, 0u);
+			blocks.push_back(p);
+		}
+		ASSERT_EQ(upstream.maxAlignment, 64u);
+		for (std::size_t i {0}; i != blocks.size(); ++i) {
+			pool.deallocate(blocks[i], 64, i < 1'000 ? 8 : 64);
+		}
+		pool.trim();
+		ASSERT_EQ(pool.chunks(), 0u);
+		ASSERT_EQ(upstream.bytesInUse, 0u);
+	}
+	{
+		::containers::pmr::PoolResource pool {&upstream, 1 << 12, true};
+		ASSERT_TRUE(pool.sizeAlignedChunks());
+		std::vector<void*> blocks;
+		for (int i {0}; i != 1'000; ++i) {
+			void* p {pool.allocate(24, 8)};
+			//a block never crosses the boundary of its size
+			ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p) % 32, 0u);
+			blocks.push_back(p);
+		}
+		ASSERT_EQ(upstream.maxAlignment, std::size_t{1} << 12);
+		for (void* p : blocks) {
+			pool.deallocate(p, 24, 8);
+		}
+		pool.trim();
+		ASSERT_EQ(pool.chunks(), 0u);
+	}
+	ASSERT_EQ(upstream.bytesInUse, 0u);
+	ASSERT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST(hash_table_pmr, table_trim) {
+	CountingResource upstream;
+	::containers::pmr::PoolResource pool {&upstream};
+	::containers::hash_table::Map<int, int> hashTable (0, &pool);
+	for (int i {0}; i != 100'000; ++i) {
+		hashTable.insert(i, i);
+	}
+	std::size_t const peak {upstream.bytesInUse};
+	for (int i {0}; i != 99'000; ++i) {
+		hashTable.erase(i);
+	}
+	ASSERT_GT(hashTable.trim(), 0u);
+	ASSERT_LT(upstream.bytesInUse, peak / 2);
+	for (int i {99'000}; i != 100'000; ++i) {
+		ASSERT_EQ(hashTable.find(i)->second, i);
+	}
+
+	hashTable.clear();
+	hashTable.trim();
+	ASSERT_EQ(pool.chunks(), 0u);
+}
+
+TEST(hash_table_pmr, table_auto_trim) {
+	::containers::pmr::PoolResource pool;
+	::containers::hash_table::Set<int> hashTable (0, &pool);
+	hashTable.setAutoTrim(1 << 12);
+	for (int i {0}; i != 100'000; ++i) {
+		hashTable.insert(i);
+	}
+	std::size_t const peakChunks {pool.chunks()};
+	for (int i {0}; i != 100'000; ++i) {
+		hashTable.erase(i);
+	}
+	ASSERT_LT(pool.chunks(), peakChunks / 2);
+	ASSERT_TRUE(hashTable.empty());
+}
+
+TEST(hash_table_pmr, pool_resource_reserve) {
+	::containers::pmr::PoolResource pool {std::pmr::get_default_resource(), 1 << 12};
+	ASSERT_GT(pool.reserve(24, 8, 1'000), 0u);
+	std::size_t const chunks {pool.chunks()};
+	std::vector<void*> blocks;
+	for (int i {0}; i != 1'000; ++i) {
+		blocks.push_back(pool.allocate(24, 8));
+	}
+	ASSERT_EQ(pool.chunks(), chunks);
+	ASSERT_EQ(pool.reserve(24, 8, 0), 0u);
+	for (void* p : blocks) {
+		pool.deallocate(p, 24, 8);
+	}
+}
+
+TEST(hash_table_pmr, table_reserve_nodes) {
+	::containers::pmr::PoolResource pool;
+	::containers::hash_table::Map<int, int> hashTable (0, &pool);
+	hashTable.reserve(50'000, true);
+	std::size_t const chunks {pool.chunks()};
+	std::size_t const cap {hashTable.capacity()};
+	ASSERT_GT(chunks, 0u);
+	for (int i {0}; i != 50'000; ++i) {
+		hashTable.insert(i, i);
+	}
+	ASSERT_EQ(pool.chunks(), chunks);
+	ASSERT_EQ(hashTable.capacity(), cap);
+}
+
+TEST(hash_table_pmr, bulk_erase_single_resize) {
+	CountingResource indexResource;
+	::containers::hash_table::Map<int, int> hashTable (0, std::pmr::new_delete_resource(), &indexResource);
+	for (int i {0}; i != 100'000; ++i) {
+		hashTable.insert(i, i);
+	}
+	std::size_t const capacityBefore {hashTable.capacity()};
+	std::size_t const allocationsBefore {indexResource.allocations};
+
+	//erasing 90% one by one would shrink the index several times on the way
+	std::size_t const erased {erase_if(hashTable, [](auto const& kv) { return kv.first % 10 != 0; })};
+	ASSERT_EQ(erased, 90'000u);
+	ASSERT_EQ(hashTable.size(), 10'000u);
+	ASSERT_LT(hashTable.capacity(), capacityBefore);
+	ASSERT_EQ(indexResource.allocations - allocationsBefore, 1u);
+	for (int i {0}; i != 100'000; ++i) {
+		ASSERT_EQ(hashTable.contains(i), i % 10 == 0);
+	}
+}
+
+TEST(hash_table_pmr, move_leaves_no_index) {
+	CountingResource indexResource;
+	::containers::hash_table::Map<int, int> source (0, std::pmr::new_delete_resource(), &indexResource);
+	for (int i {0}; i != 1'000; ++i) {
+		source.insert(i, i);
+	}
+	std::size_t const allocationsBefore {indexResource.allocations};
+	::containers::hash_table::Map<int, int> target (std::move(source));
+	::containers::hash_table::Map<int, int> other (0, std::pmr::new_delete_resource(), &indexResource);
+	other = std::move(target);
+	//one index for other's constructor, none by the moves
+	ASSERT_EQ(indexResource.allocations - allocationsBefore, 1u);
+	ASSERT_EQ(other.size(), 1'000u);
+
+	ASSERT_TRUE(source.empty());
+	ASSERT_EQ(source.capacity(), 0u);
+	ASSERT_FALSE(source.contains(1));
+	source.erase(1);
+	ASSERT_TRUE(source.empty());
+	std::vector<int> const keys {1, 2};
+	std::vector<::containers::hash_table::Map<int, int>::const_iterator> found (keys.size());
+	source.find_many(keys, found);
+	ASSERT_EQ(found[0], source.cend());
+	ASSERT_EQ(found[1], source.cend());
+
+	//the index is back with the first insert
+	source.insert(7, 7);
+	ASSERT_GT(source.capacity(), 0u);
+	ASSERT_EQ(source.find(7)->second, 7);
+	target.insert(8, 8);
+	ASSERT_EQ(target.size(), 1u);
+}